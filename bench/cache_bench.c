@@ -0,0 +1,108 @@
+/*
+ * Hit rate and throughput of the LRU and CLOCK policies on a Zipfian trace.
+ * Every miss is followed by a put, as in a read-through cache.
+ *
+ * Usage: cache_bench [keys] [requests] [capacity] [zipf exponent]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include "../hash.h"
+#include "../cache.h"
+
+static long
+hash_key(void *key) {
+   return (long)hash_u64((uintptr_t)key, 0);
+}
+
+static bool
+equals_key(void *a, void *b) {
+   return a == b;
+}
+
+static uint64_t
+now_ns(void) {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* Draws the trace by inverting the cumulative Zipf distribution */
+static uint32_t *
+zipf_trace(uint32_t keys, uint32_t requests, double s) {
+   double *cdf = (double *)malloc(keys * sizeof(double));
+   uint32_t *trace = (uint32_t *)malloc(requests * sizeof(uint32_t));
+   uint64_t x = 88172645463325252ULL;
+   double sum = 0;
+   uint32_t i;
+
+   for (i=0; i < keys; i++) {
+      sum += 1.0 / pow(i + 1, s);
+      cdf[i] = sum;
+   }
+
+   for (i=0; i < requests; i++) {
+      double u;
+      uint32_t lo = 0, hi = keys - 1;
+
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      u = (double)(x >> 11) / (1ULL << 53) * sum;
+
+      while (lo < hi) {
+         uint32_t mid = lo + (hi - lo) / 2;
+         if (cdf[mid] < u) {
+            lo = mid + 1;
+         } else {
+            hi = mid;
+         }
+      }
+
+      trace[i] = lo;
+   }
+
+   free(cdf);
+   return trace;
+}
+
+static void
+run(const char *name, cache_policy policy, uint32_t *trace, uint32_t requests, uint64_t capacity) {
+   cache *c = cache_create(hash_key, equals_key, policy, capacity, NULL, NULL);
+   uint64_t start = now_ns();
+   uint32_t i;
+
+   for (i=0; i < requests; i++) {
+      void *key = (void *)(uintptr_t)(trace[i] + 1);
+
+      if (cache_get(c, key) == NULL) {
+         cache_put(c, key, key);
+      }
+   }
+
+   printf("%-6s hit rate %5.1f%%  %6.2f Mops/s\n", name, 
+         100.0 * c->hits / (c->hits + c->misses), (double)requests * 1000 / (now_ns() - start));
+
+   cache_destroy(c);
+}
+
+int
+main(int argc, char **argv) {
+   uint32_t keys = argc > 1 ? (uint32_t)atoi(argv[1]) : 1000000;
+   uint32_t requests = argc > 2 ? (uint32_t)atoi(argv[2]) : 5000000;
+   uint64_t capacity = argc > 3 ? (uint64_t)atoll(argv[3]) : 100000;
+   double s = argc > 4 ? atof(argv[4]) : 0.99;
+   uint32_t *trace = zipf_trace(keys, requests, s);
+
+   printf("%u keys, %u requests, capacity %lu, zipf %.2f\n", keys, requests, 
+         (unsigned long)capacity, s);
+   run("LRU", CACHE_LRU, trace, requests, capacity);
+   run("CLOCK", CACHE_CLOCK, trace, requests, capacity);
+
+   free(trace);
+   return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * Throughput of chtab with 1..N threads on a mixed workload. Every thread
+ * runs the same number of operations on a shared table of KEYS keys, so
+ * with perfect scaling the rate grows linearly with the number of threads.
+ *
+ * Usage: chtab_bench [max threads] [percent writes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "../hash.h"
+#include "../chtab.h"
+
+#define KEYS  (1 << 16)
+#define OPS   (1 << 21)
+
+static chtab *table;
+static int writes;
+
+static long
+hash_key(void *key) {
+   return (long)hash_u64((uintptr_t)key, 0);
+}
+
+static bool
+equals_key(void *a, void *b) {
+   return a == b;
+}
+
+static uint64_t
+now_ns(void) {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void *
+worker(void *arg) {
+   uint64_t x = (uintptr_t)arg * 0x9e3779b97f4a7c15 + 1;
+   uint32_t i;
+
+   for (i=0; i < OPS; i++) {
+      void *key;
+
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      key = (void *)(uintptr_t)((x % KEYS) + 1);
+
+      if ((int)((x >> 32) % 100) >= writes) {
+         chtab_get(table, key);
+      } else if (x & (1ULL << 63)) {
+         chtab_put(table, key, key);
+      } else {
+         chtab_delete(table, key);
+      }
+   }
+
+   return NULL;
+}
+
+int
+main(int argc, char **argv) {
+   long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+   int max = argc > 1 ? atoi(argv[1]) : (int)(cpus > 0 ? cpus : 1);
+   int n, i;
+
+   writes = argc > 2 ? atoi(argv[2]) : 10;
+   printf("threads  Mops/s  (%d%% writes, %d keys)\n", writes, KEYS);
+
+   for (n=1; n <= max; n++) {
+      pthread_t *threads = (pthread_t *)calloc(n, sizeof(pthread_t));
+      uint64_t start;
+
+      table = chtab_create(hash_key, equals_key, NULL);
+      for (i=0; i < KEYS; i += 2) {
+         chtab_put(table, (void *)(uintptr_t)(i + 1), (void *)(uintptr_t)(i + 1));
+      }
+
+      start = now_ns();
+      for (i=0; i < n; i++) {
+         pthread_create(&threads[i], NULL, worker, (void *)(uintptr_t)(i + 1));
+      }
+      for (i=0; i < n; i++) {
+         pthread_join(threads[i], NULL);
+      }
+
+      printf("%7d  %6.2f\n", n, (double)n * OPS * 1000 / (now_ns() - start));
+
+      chtab_destroy(table);
+      free(threads);
+   }
+
+   return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Lookup latency and memory of a frozen ftab against the htab it was built
+ * from. Half of the lookups are misses, in random order.
+ *
+ * Usage: ftab_bench [number of keys]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../ftab.h"
+
+static uint64_t
+now_ns(void) {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+int
+main(int argc, char **argv) {
+   uint32_t n = argc > 1 ? (uint32_t)atoi(argv[1]) : 2000000;
+   int64_t *keys = (int64_t *)malloc(2 * (size_t)n * sizeof(int64_t));
+   uint32_t *order = (uint32_t *)malloc(2 * (size_t)n * sizeof(uint32_t));
+   htab *ht = htab_create_with(HTAB_KEY_INT64);
+   uint64_t x = 88172645463325252ULL, start, sum = 0, bytes;
+   htab_stats stats;
+   ftab *f;
+   uint32_t i;
+
+   /* Random keys, the second half is never inserted */
+   for (i=0; i < 2 * n; i++) {
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      keys[i] = (int64_t)x;
+      order[i] = i;
+   }
+
+   for (i=2 * n - 1; i > 0; i--) {
+      uint32_t j = (uint64_t)keys[i] % (i + 1), t = order[i];
+      order[i] = order[j];
+      order[j] = t;
+   }
+
+   for (i=0; i < n; i++) {
+      htab_put(ht, &keys[i], &keys[i]);
+   }
+
+   start = now_ns();
+   f = ftab_freeze(ht);
+   printf("freeze %u keys: %.2f s\n", n, (double)(now_ns() - start) / 1e9);
+
+   start = now_ns();
+   for (i=0; i < 2 * n; i++) {
+      sum += htab_get(ht, &keys[order[i]]) != NULL;
+   }
+   printf("htab get   %7.1f ns/op\n", (double)(now_ns() - start) / (2 * n));
+
+   start = now_ns();
+   for (i=0; i < 2 * n; i++) {
+      sum += ftab_get(f, &keys[order[i]]) != NULL;
+   }
+   printf("ftab get   %7.1f ns/op\n", (double)(now_ns() - start) / (2 * n));
+
+   /* Without the keys and values, which both tables share */
+   htab_get_stats(ht, &stats, false);
+   printf("htab       %7.1f bytes/key, %u allocations\n", 
+         (double)(stats.bucket_bytes + stats.entry_bytes + stats.filter_bytes) / n, n + 1);
+
+   bytes = (uint64_t)f->size * sizeof(ftab_entry) + (f->size + 63) / 64 * sizeof(uint64_t) + 
+         (uint64_t)f->nbuckets * sizeof(uint32_t) + (uint64_t)f->noverflow * sizeof(ftab_entry);
+   printf("ftab       %7.1f bytes/key, 4 allocations\n", (double)bytes / n);
+
+   ftab_destroy(f);
+   htab_destroy(ht);
+   free(keys);
+   free(order);
+
+   /* Keeps the lookups from being optimized away */
+   return sum != n * 2;
+}
@@ -0,0 +1,85 @@
+/*
+ * Compares the engines behind htab_engine.h. The same source is built as 
+ * htab_bench on the chained htab and as htab_bench_oa on oatab, so it also
+ * shows that callers switch engines without any change.
+ *
+ * Usage: htab_bench [number of keys]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../htab_engine.h"
+
+static uint64_t
+now_ns(void) {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void
+report(const char *what, uint64_t start, uint32_t n) {
+   printf("%-8s %-12s %7.1f ns/op\n", HTAB_ENGINE, what, (double)(now_ns() - start) / n);
+}
+
+int
+main(int argc, char **argv) {
+   uint32_t n = argc > 1 ? (uint32_t)atoi(argv[1]) : 1000000;
+   int64_t *keys = (int64_t *)malloc(2 * (size_t)n * sizeof(int64_t));
+   htab *ht = htab_create_with(HTAB_KEY_INT64);
+   uint64_t x = 88172645463325252ULL, start, sum = 0;
+   htab_it *it;
+   uint32_t i;
+
+   /* Random keys, the second half is never inserted */
+   for (i=0; i < 2 * n; i++) {
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      keys[i] = (int64_t)x;
+   }
+
+   start = now_ns();
+   for (i=0; i < n; i++) {
+      htab_put(ht, &keys[i], &keys[i]);
+   }
+   report("put", start, n);
+
+   start = now_ns();
+   for (i=0; i < n; i++) {
+      sum += htab_get(ht, &keys[i]) != NULL;
+   }
+   report("get hit", start, n);
+
+   start = now_ns();
+   for (i=n; i < 2 * n; i++) {
+      sum += htab_get(ht, &keys[i]) != NULL;
+   }
+   report("get miss", start, n);
+
+   start = now_ns();
+   it = htab_it_create(ht);
+   while (htab_it_has_next(it)) {
+      sum += htab_it_get_next(it)->key != NULL;
+   }
+   htab_it_destroy(it);
+   report("iterate", start, n);
+
+   start = now_ns();
+   for (i=0; i < n; i++) {
+      htab_entry *entry = htab_delete(ht, &keys[i]);
+      if (entry) {
+         htab_entry_destroy(entry);
+      }
+   }
+   report("delete", start, n);
+
+   htab_destroy(ht);
+   free(keys);
+
+   /* Keeps the lookups from being optimized away */
+   return sum == 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * Compares a table generated by HTAB_DECLARE with long keys stored inline 
+ * against htab with malloc'ed long keys, on the same random keys.
+ *
+ * Usage: htab_gen_bench [number of keys]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../htab.h"
+#include "../htab_gen.h"
+
+static inline uint64_t
+hash_long(long k) {
+   return htab_gen_hash_int(k);
+}
+
+static inline bool
+eq_long(long a, long b) {
+   return a == b;
+}
+
+HTAB_DECLARE(lmap, long, long, hash_long, eq_long)
+
+static uint64_t
+now_ns(void) {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void
+report(const char *engine, const char *what, uint64_t start, uint32_t n) {
+   printf("%-10s %-10s %7.1f ns/op\n", engine, what, (double)(now_ns() - start) / n);
+}
+
+int
+main(int argc, char **argv) {
+   uint32_t n = argc > 1 ? (uint32_t)atoi(argv[1]) : 1000000;
+   long *keys = (long *)malloc(2 * (size_t)n * sizeof(long));
+   uint64_t x = 88172645463325252ULL, start, sum = 0;
+   lmap *m = lmap_create();
+   htab *ht = htab_create_with(HTAB_KEY_INT64);
+   uint32_t i;
+
+   /* Random keys, the second half is never inserted */
+   for (i=0; i < 2 * n; i++) {
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      keys[i] = (long)x;
+   }
+
+   start = now_ns();
+   for (i=0; i < n; i++) {
+      lmap_put(m, keys[i], i, NULL);
+   }
+   report("htab_gen", "put", start, n);
+
+   start = now_ns();
+   for (i=0; i < n; i++) {
+      sum += lmap_get(m, keys[i]) != NULL;
+   }
+   report("htab_gen", "get hit", start, n);
+
+   start = now_ns();
+   for (i=n; i < 2 * n; i++) {
+      sum += lmap_get(m, keys[i]) != NULL;
+   }
+   report("htab_gen", "get miss", start, n);
+
+   start = now_ns();
+   for (i=0; i < n; i++) {
+      lmap_delete(m, keys[i], NULL);
+   }
+   report("htab_gen", "delete", start, n);
+
+   /* The generic table needs a pointer to the key, so every key is boxed */
+   start = now_ns();
+   for (i=0; i < n; i++) {
+      long *key = (long *)malloc(sizeof(long));
+      *key = keys[i];
+      htab_put(ht, key, key);
+   }
+   report("htab", "put", start, n);
+
+   start = now_ns();
+   for (i=0; i < n; i++) {
+      sum += htab_get(ht, &keys[i]) != NULL;
+   }
+   report("htab", "get hit", start, n);
+
+   start = now_ns();
+   for (i=n; i < 2 * n; i++) {
+      sum += htab_get(ht, &keys[i]) != NULL;
+   }
+   report("htab", "get miss", start, n);
+
+   start = now_ns();
+   for (i=0; i < n; i++) {
+      htab_entry *entry = htab_delete(ht, &keys[i]);
+      if (entry) {
+         free(entry->key);
+         htab_entry_destroy(entry);
+      }
+   }
+   report("htab", "delete", start, n);
+
+   lmap_destroy(m);
+   htab_destroy(ht);
+   free(keys);
+
+   /* Keeps the lookups from being optimized away */
+   return sum == 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * mmheap against olist as a double ended priority queue, on a scheduler
+ * trace: ITEMS random keys are loaded in bulk, then OPS operations push a
+ * random key (50%), pop the smallest (35%) or pop the greatest (15%). Both
+ * run the same trace, the sum of the popped keys must match.
+ *
+ * Usage: mmheap_bench [items] [ops]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../mmheap.h"
+#include "../olist.h"
+
+#define ITEMS 100000  /* Keys loaded before the trace */
+#define OPS   1000000 /* Operations in the trace */
+
+enum { PUSH, POP_MIN, POP_MAX };
+
+static uint64_t compares;
+
+static int
+cmp_key(void *a, void *b) {
+   compares++;
+   return ((uintptr_t)a > (uintptr_t)b) - ((uintptr_t)a < (uintptr_t)b);
+}
+
+static uint64_t
+now_ns(void) {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void
+report(const char *name, const char *what, uint64_t ns, uint64_t cmp, uint32_t n) {
+   printf("%-7s %-6s %10.1f ns %10.1f cmp/op\n", name, what,
+         (double)ns / n, (double)cmp / n);
+}
+
+int
+main(int argc, char **argv) {
+   uint32_t items = argc > 1 ? (uint32_t)atoi(argv[1]) : ITEMS;
+   uint32_t ops = argc > 2 ? (uint32_t)atoi(argv[2]) : OPS;
+   uint64_t rng = 88172645463325252ULL, start, heap_sum = 0, list_sum = 0;
+   void **values = (void **)malloc((items ? items : 1) * sizeof(void *));
+   uintptr_t *keys = (uintptr_t *)malloc((ops ? ops : 1) * sizeof(uintptr_t));
+   unsigned char *trace = (unsigned char *)malloc(ops ? ops : 1);
+   mmheap *h;
+   olist *l;
+   uint32_t i;
+
+   if (items == 0 || ops == 0) {
+      fprintf(stderr, "usage: mmheap_bench [items] [ops]\n");
+      return 1;
+   }
+
+   for (i=0; i < items; i++) {
+      rng ^= rng << 13;
+      rng ^= rng >> 7;
+      rng ^= rng << 17;
+      values[i] = (void *)(uintptr_t)(rng >> 32);
+   }
+   for (i=0; i < ops; i++) {
+      rng ^= rng << 13;
+      rng ^= rng >> 7;
+      rng ^= rng << 17;
+      keys[i] = (uintptr_t)(rng >> 32);
+      trace[i] = rng % 100 < 50 ? PUSH : rng % 100 < 85 ? POP_MIN : POP_MAX;
+   }
+
+   compares = 0;
+   start = now_ns();
+   h = mmheap_heapify(cmp_key, values, items);
+   report("mmheap", "load", now_ns() - start, compares, items);
+
+   compares = 0;
+   start = now_ns();
+   for (i=0; i < ops; i++) {
+      if (trace[i] == PUSH || mmheap_is_empty(h)) {
+         mmheap_push(h, (void *)keys[i]);
+      } else if (trace[i] == POP_MIN) {
+         heap_sum += (uintptr_t)mmheap_pop_min(h);
+      } else {
+         heap_sum += (uintptr_t)mmheap_pop_max(h);
+      }
+   }
+   report("mmheap", "trace", now_ns() - start, compares, ops);
+
+   compares = 0;
+   start = now_ns();
+   l = olist_create(cmp_key);
+   olist_insert_many(l, values, items);
+   report("olist", "load", now_ns() - start, compares, items);
+
+   compares = 0;
+   start = now_ns();
+   for (i=0; i < ops; i++) {
+      if (trace[i] == PUSH || olist_is_empty(l)) {
+         olist_insert(l, (void *)keys[i]);
+      } else if (trace[i] == POP_MIN) {
+         list_sum += (uintptr_t)olist_remove_first(l);
+      } else {
+         list_sum += (uintptr_t)olist_remove_last(l);
+      }
+   }
+   report("olist", "trace", now_ns() - start, compares, ops);
+
+   if (heap_sum != list_sum || mmheap_size(h) != olist_size(l)) {
+      fprintf(stderr, "mmheap and olist differ\n");
+      return 1;
+   }
+
+   mmheap_destroy(h);
+   olist_destroy(l);
+   free(values);
+   free(keys);
+   free(trace);
+
+   return 0;
+}
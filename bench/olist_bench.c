@@ -0,0 +1,249 @@
+/*
+ * Cost of olist_insert at growing sizes, against the linear insert olist 
+ * used before the skip list: a scan from the first entry of a sorted 
+ * doubly linked list. Both are measured by inserting random keys into a 
+ * list which already holds n keys, at most n/10 of them so the size stays
+ * close to n.
+ *
+ * The second part is a cancel heavy timer workload: TIMERS timers ordered by 
+ * deadline, of which one in four operations fires the first and re-arms it, 
+ * the others reschedule a random timer. Rescheduling is measured through 
+ * olist_remove_handle and olist_insert, through olist_update_key and through 
+ * olist_remove by value and olist_insert. All three run the same trace.
+ *
+ * Usage: olist_bench [sizes...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../olist.h"
+
+#define SAMPLES        10000   /* Most inserts measured per size */
+#define LINEAR_SAMPLES 1000    /* Most inserts measured per size on the linear list */
+#define LINEAR_MAX     1000000 /* Largest size the linear list is measured at */
+#define TIMERS         100000  /* Timers in the timer workload */
+#define TIMER_OPS      1000000 /* Operations in the timer workload */
+#define TIMER_DELAY    1000000 /* Largest delay a timer is armed with */
+
+enum { BY_HANDLE, BY_UPDATE, BY_VALUE };
+
+typedef struct node {
+   uintptr_t value;
+   struct node *prev;
+   struct node *next;
+} node;
+
+typedef struct timer {
+   uint64_t deadline;
+   olist_entry *handle;
+} timer;
+
+static uint64_t compares;
+static uint64_t rng = 88172645463325252ULL;
+
+static int
+cmp_key(void *a, void *b) {
+   compares++;
+   return ((uintptr_t)a > (uintptr_t)b) - ((uintptr_t)a < (uintptr_t)b);
+}
+
+/* Equal deadlines are ordered by address, so olist_remove finds the timer */
+static int
+cmp_timer(void *a, void *b) {
+   timer *x = (timer *)a, *y = (timer *)b;
+
+   compares++;
+   if (x->deadline != y->deadline) {
+      return x->deadline > y->deadline ? 1 : -1;
+   }
+   return (x > y) - (x < y);
+}
+
+static uintptr_t
+random_key(void) {
+   rng ^= rng << 13;
+   rng ^= rng >> 7;
+   rng ^= rng << 17;
+   return (uintptr_t)(rng >> 32);
+}
+
+static uint64_t
+now_ns(void) {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int
+cmp_sort(const void *a, const void *b) {
+   uintptr_t x = *(const uintptr_t *)a, y = *(const uintptr_t *)b;
+   return (x > y) - (x < y);
+}
+
+static uint32_t
+samples(uint32_t n, uint32_t max) {
+   return n / 10 < 1 ? 1 : n / 10 < max ? n / 10 : max;
+}
+
+static void
+skiplist(uint32_t n) {
+   olist *l = olist_create(cmp_key);
+   uint32_t i, m = samples(n, SAMPLES);
+   uint64_t start;
+
+   for (i=0; i < n; i++) {
+      olist_insert(l, (void *)random_key());
+   }
+
+   compares = 0;
+   start = now_ns();
+   for (i=0; i < m; i++) {
+      olist_insert(l, (void *)random_key());
+   }
+
+   printf("%10u  skip list %10.1f ns %10.1f cmp/insert\n", n, 
+         (double)(now_ns() - start) / m, (double)compares / m);
+
+   olist_destroy(l);
+}
+
+/* Inserts like olist did before the skip list */
+static void
+linear_insert(node **first, uintptr_t value) {
+   node *e = (node *)calloc(1, sizeof(node)), *prev = NULL, *cur;
+
+   e->value = value;
+   for (cur=*first; cur && cmp_key((void *)cur->value, (void *)value) < 0; cur=cur->next) {
+      prev = cur;
+   }
+
+   e->prev = prev;
+   e->next = cur;
+   if (cur) {
+      cur->prev = e;
+   }
+   if (prev) {
+      prev->next = e;
+   } else {
+      *first = e;
+   }
+}
+
+static void
+linear(uint32_t n) {
+   uintptr_t *values = (uintptr_t *)malloc((n ? n : 1) * sizeof(uintptr_t));
+   node *first = NULL, *e;
+   uint32_t i, m = samples(n, LINEAR_SAMPLES);
+   uint64_t start;
+
+   /* The list is built from sorted keys, an insert would take O(n) each */
+   for (i=0; i < n; i++) {
+      values[i] = random_key();
+   }
+   qsort(values, n, sizeof(uintptr_t), cmp_sort);
+   for (i=n; i > 0; i--) {
+      e = (node *)calloc(1, sizeof(node));
+      e->value = values[i-1];
+      e->next = first;
+      if (first) {
+         first->prev = e;
+      }
+      first = e;
+   }
+
+   compares = 0;
+   start = now_ns();
+   for (i=0; i < m; i++) {
+      linear_insert(&first, random_key());
+   }
+
+   printf("%10u  linear    %10.1f ns %10.1f cmp/insert\n", n, 
+         (double)(now_ns() - start) / m, (double)compares / m);
+
+   while (first) {
+      e = first->next;
+      free(first);
+      first = e;
+   }
+   free(values);
+}
+
+static void
+timers(int how) {
+   static const char *names[] = { "remove_handle", "update_key", "remove" };
+   timer *t = (timer *)malloc(TIMERS * sizeof(timer)), *e;
+   olist *l = olist_create(cmp_timer);
+   uint64_t clock = 0, start, seed = rng;
+   uint32_t i;
+
+   for (i=0; i < TIMERS; i++) {
+      t[i].deadline = random_key() % TIMER_DELAY;
+      t[i].handle = olist_insert(l, &t[i]);
+   }
+
+   compares = 0;
+   start = now_ns();
+   for (i=0; i < TIMER_OPS; i++) {
+      uintptr_t r = random_key();
+
+      if (r % 4 == 0) {
+         /* Fires the first timer and arms it again */
+         e = (timer *)olist_remove_first(l);
+         clock = e->deadline;
+         e->deadline = clock + 1 + r / 4 % TIMER_DELAY;
+         e->handle = olist_insert(l, e);
+         continue;
+      }
+
+      e = &t[r / 4 % TIMERS];
+      switch (how) {
+      case BY_HANDLE:
+         olist_remove_handle(l, e->handle);
+         e->deadline = clock + 1 + random_key() % TIMER_DELAY;
+         e->handle = olist_insert(l, e);
+         break;
+      case BY_UPDATE:
+         e->deadline = clock + 1 + random_key() % TIMER_DELAY;
+         olist_update_key(l, e->handle);
+         break;
+      default:
+         olist_remove(l, e);
+         e->deadline = clock + 1 + random_key() % TIMER_DELAY;
+         e->handle = olist_insert(l, e);
+         break;
+      }
+   }
+
+   printf("%10u  timers %-13s %10.1f ns %10.1f cmp/op\n", TIMERS, names[how],
+         (double)(now_ns() - start) / TIMER_OPS, (double)compares / TIMER_OPS);
+
+   olist_destroy(l);
+   free(t);
+   rng = seed;
+}
+
+int
+main(int argc, char **argv) {
+   uint32_t defaults[] = { 1000, 100000, 10000000 };
+   uint32_t i, count = argc > 1 ? (uint32_t)argc - 1 : 3;
+
+   for (i=0; i < count; i++) {
+      uint32_t n = argc > 1 ? (uint32_t)atoi(argv[i+1]) : defaults[i];
+
+      skiplist(n);
+      if (n <= LINEAR_MAX) {
+         linear(n);
+      } else {
+         printf("%10u  linear    not run, about %u cmp/insert\n", n, n / 2);
+      }
+   }
+
+   timers(BY_HANDLE);
+   timers(BY_UPDATE);
+   timers(BY_VALUE);
+
+   return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bloom.h"
+#include "hash.h"
+
+#define BLOOM_BITS   (BLOOM_BLOCK * 64)
+
+/* Creates a filter for n keys at about bits_per_key bits each. With 10 bits 
+ * per key the false positive rate is around 1%. */
+bloom *
+bloom_create(uint32_t n, uint32_t bits_per_key) {
+   bloom *f = (bloom *)calloc(1, sizeof(bloom));
+   uint64_t bits = (uint64_t)n * bits_per_key;
+
+   f->nblocks = (bits + BLOOM_BITS - 1) / BLOOM_BITS;
+   if (f->nblocks == 0) {
+      f->nblocks = 1;
+   }
+
+   /* ln 2 * bits per key is optimal, a blocked filter does better with a
+    * little less */
+   f->k = bits_per_key * 2 / 3;
+   f->k = f->k < 1 ? 1 : f->k > 16 ? 16 : f->k;
+
+   f->blocks = (uint64_t *)aligned_alloc(64, (size_t)f->nblocks * BLOOM_BLOCK * sizeof(uint64_t));
+   bloom_clear(f);
+
+   return f;
+}
+
+void
+bloom_destroy(bloom *f) {
+   free(f->blocks);
+   free(f);
+}
+
+void
+bloom_clear(bloom *f) {
+   memset(f->blocks, 0, (size_t)f->nblocks * BLOOM_BLOCK * sizeof(uint64_t));
+}
+
+static inline uint64_t *
+bloom_block(bloom *f, uint64_t h) {
+   return &f->blocks[((h >> 32) * f->nblocks >> 32) * BLOOM_BLOCK];
+}
+
+/* The bit positions are taken 9 bits at a time from the low half of the 
+ * hash, which is mixed again every 3 positions */
+#define BLOOM_FOREACH_BIT(f, h, bit, body)              \
+   do {                                                 \
+      uint64_t _x = (h);                                \
+      uint32_t _i;                                      \
+      for (_i=0; _i < (f)->k; _i++) {                   \
+         if (_i % 3 == 0) {                             \
+            _x = _x * 0x9e3779b97f4a7c15ULL + _i;       \
+         }                                              \
+         bit = (_x >> (9 * (_i % 3))) & (BLOOM_BITS-1); \
+         body                                           \
+      }                                                 \
+   } while (0)
+
+void
+bloom_add(bloom *f, uint64_t hash) {
+   uint64_t h = hash_u64(hash, 0);
+   uint64_t *block = bloom_block(f, h);
+   uint32_t bit;
+
+   BLOOM_FOREACH_BIT(f, h, bit, {
+      block[bit / 64] |= 1ULL << (bit % 64);
+   });
+}
+
+bool
+bloom_maybe_contains(bloom *f, uint64_t hash) {
+   uint64_t h = hash_u64(hash, 0);
+   uint64_t *block = bloom_block(f, h);
+   uint32_t bit;
+
+   BLOOM_FOREACH_BIT(f, h, bit, {
+      if (!(block[bit / 64] & (1ULL << (bit % 64)))) {
+         return false;
+      }
+   });
+
+   return true;
+}
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _BLOOM_H_
+#define _BLOOM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Blocked Bloom filter. All bits of a key are set within one block of 
+ * 512 bits, so a lookup touches a single cache line. The filter works on 
+ * 64 bit hashes of the keys, e.g. from hash.h, which are mixed again 
+ * before use. Keys can't be removed, a filter has to be cleared and 
+ * refilled instead.
+ */
+
+#define BLOOM_BLOCK  8 /* Number of 64 bit words per block */
+
+typedef struct bloom {
+   uint64_t *blocks;           /* Array of blocks */
+   uint32_t nblocks;           /* Number of blocks */
+   uint32_t k;                 /* Number of bits set per key */
+} bloom;
+
+bloom *bloom_create(uint32_t n, uint32_t bits_per_key);
+void bloom_destroy(bloom *f);
+void bloom_clear(bloom *f);
+void bloom_add(bloom *f, uint64_t hash);
+bool bloom_maybe_contains(bloom *f, uint64_t hash);
+
+#endif //_BLOOM_H_
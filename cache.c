@@ -0,0 +1,219 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+
+#include "cache.h"
+
+cache *
+cache_create(void *fhash, void *fequals, cache_policy policy, uint64_t capacity,
+      size_t (*sizefunc)(void *key, void *value), void (*evict)(void *key, void *value)) {
+   cache *c = (cache *)calloc(1, sizeof(cache));
+   c->ht = htab_create(fhash, fequals);
+   c->order = list_create();
+   c->policy = policy;
+   c->capacity = capacity;
+   c->sizefunc = sizefunc;
+   c->evict = evict;
+   return c;
+}
+
+void
+cache_destroy(cache *c) {
+   cache_entry *ce;
+
+   while ((ce = (cache_entry *)list_remove_first(c->order)) != NULL) {
+      if (c->evict) {
+         c->evict(ce->key, ce->value);
+      }
+      free(ce);
+   }
+
+   list_destroy(c->order);
+   htab_destroy(c->ht);
+   free(c);
+}
+
+/* Unlinks the entry from the table and the list and hands it to evict */
+static void
+cache_drop(cache *c, cache_entry *ce) {
+   htab_entry *entry = htab_delete(c->ht, ce->key);
+
+   htab_entry_destroy(entry);
+
+   if (c->hand == ce->node) {
+      c->hand = ce->node->next;
+   }
+
+   list_remove_entry(c->order, ce->node);
+   c->used -= ce->size;
+
+   if (c->evict) {
+      c->evict(ce->key, ce->value);
+   }
+
+   free(ce);
+}
+
+static cache_entry *
+cache_victim(cache *c) {
+   cache_entry *ce;
+
+   if (c->policy == CACHE_LRU) {
+      return c->order->last ? (cache_entry *)c->order->last->value : NULL;
+   }
+
+   /* Every entry is passed at most once before the hand comes back to an
+    * entry whose flag it cleared */
+   for (;;) {
+      if (!c->hand) {
+         c->hand = c->order->first;
+         if (!c->hand) {
+            return NULL;
+         }
+      }
+
+      ce = (cache_entry *)c->hand->value;
+
+      if (!ce->referenced) {
+         return ce;
+      }
+
+      ce->referenced = false;
+      c->hand = c->hand->next;
+   }
+}
+
+static void
+cache_shrink(cache *c) {
+   cache_entry *ce;
+
+   while (c->used > c->capacity && (ce = cache_victim(c)) != NULL) {
+      cache_drop(c, ce);
+      c->evictions++;
+   }
+}
+
+static inline void
+cache_use(cache *c, cache_entry *ce) {
+   if (c->policy == CACHE_LRU) {
+      list_move_first(c->order, ce->node);
+   } else {
+      ce->referenced = true;
+   }
+}
+
+void *
+cache_get(cache *c, void *key) {
+   cache_entry *ce = (cache_entry *)htab_get(c->ht, key);
+
+   if (!ce) {
+      c->misses++;
+      return NULL;
+   }
+
+   c->hits++;
+   cache_use(c, ce);
+
+   return ce->value;
+}
+
+bool
+cache_contains(cache *c, void *key) {
+   return htab_contains(c->ht, key);
+}
+
+/* Marks the entry as used without counting a hit */
+bool
+cache_touch(cache *c, void *key) {
+   cache_entry *ce = (cache_entry *)htab_get(c->ht, key);
+
+   if (!ce) {
+      return false;
+   }
+
+   cache_use(c, ce);
+
+   return true;
+}
+
+void
+cache_put(cache *c, void *key, void *value) {
+   cache_entry *ce = (cache_entry *)htab_get(c->ht, key);
+   uint64_t size = c->sizefunc ? c->sizefunc(key, value) : 1;
+
+   if (ce) {
+      void *old_key = ce->key, *old_value = ce->value;
+
+      /* The table holds the old key, replace it along with the value */
+      htab_entry_destroy(htab_put(c->ht, key, ce));
+      ce->key = key;
+      ce->value = value;
+      c->used = c->used - ce->size + size;
+      ce->size = size;
+      cache_use(c, ce);
+
+      /* Pointers which are still in use are passed as NULL */
+      if (c->evict && (old_key != key || old_value != value)) {
+         c->evict(old_key != key ? old_key : NULL, old_value != value ? old_value : NULL);
+      }
+   } else {
+      ce = (cache_entry *)calloc(1, sizeof(cache_entry));
+      ce->key = key;
+      ce->value = value;
+      ce->size = size;
+
+      if (c->policy == CACHE_LRU) {
+         ce->node = list_insert(c->order, ce);
+      } else {
+         ce->node = list_append(c->order, ce);
+      }
+
+      htab_put(c->ht, key, ce);
+      c->used += size;
+   }
+
+   cache_shrink(c);
+}
+
+bool
+cache_remove(cache *c, void *key) {
+   cache_entry *ce = (cache_entry *)htab_get(c->ht, key);
+
+   if (!ce) {
+      return false;
+   }
+
+   cache_drop(c, ce);
+
+   return true;
+}
+
+inline uint32_t
+cache_size(cache *c) {
+   return list_size(c->order);
+}
@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _CACHE_H_
+#define _CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "htab.h"
+#include "list.h"
+
+/*
+ * Bounded cache on top of htab and list. With CACHE_LRU the list is kept
+ * in order of use and a hit moves the entry to the front. With CACHE_CLOCK
+ * a hit only sets a flag, and a hand sweeping over the list in insertion 
+ * order evicts the first entry whose flag isn't set, clearing the flags it
+ * passes. Every entry leaving the cache, by eviction, replacement, removal
+ * or destruction of the cache, is passed to the evict callback. When an
+ * entry is replaced, a key or value which is still in use is passed as NULL.
+ */
+
+typedef enum {
+   CACHE_LRU,
+   CACHE_CLOCK
+} cache_policy;
+
+typedef struct {
+   void *key;
+   void *value;
+   uint64_t size;               /* Size as returned by sizefunc */
+   list_entry *node;            /* Position in the list */
+   bool referenced;             /* Used since the hand last passed, CLOCK only */
+} cache_entry;
+
+typedef struct {
+   htab *ht;                    /* Maps keys to cache_entrys */
+   list *order;                 /* Entries in order of use or insertion */
+   list_entry *hand;            /* Next entry the CLOCK hand looks at */
+   cache_policy policy;
+   uint64_t capacity;           /* Maximum total size */
+   uint64_t used;               /* Total size of the entries */
+   uint64_t hits;
+   uint64_t misses;
+   uint64_t evictions;
+   size_t (*sizefunc)(void *key, void *value); /* Size of an entry, 1 if NULL */
+   void (*evict)(void *key, void *value);      /* Called for leaving entries, may be NULL */
+} cache;
+
+cache *cache_create(void *fhash, void *fequals, cache_policy policy, uint64_t capacity,
+      size_t (*sizefunc)(void *key, void *value), void (*evict)(void *key, void *value));
+void cache_destroy(cache *c);
+void *cache_get(cache *c, void *key);
+bool cache_contains(cache *c, void *key);
+bool cache_touch(cache *c, void *key);
+void cache_put(cache *c, void *key, void *value);
+bool cache_remove(cache *c, void *key);
+uint32_t cache_size(cache *c);
+
+#endif //_CACHE_H_
@@ -0,0 +1,450 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <sched.h>
+
+#include "chtab.h"
+
+static atomic_uint next_reader;
+static _Thread_local int reader_slot = -1;
+
+static chtab_table *
+table_create(uint32_t size) {
+   chtab_table *t = (chtab_table *)calloc(1, sizeof(chtab_table));
+   t->htsize = size;
+   t->mask = size - 1;
+   t->buckets = (chtab_entry *_Atomic *)calloc(size, sizeof(chtab_entry *));
+   return t;
+}
+
+/* Frees the table and the entries still linked into it */
+static void
+table_destroy(chtab_table *t, void (*free_entry)(void *key, void *value)) {
+   uint32_t i;
+
+   for (i=0; i < t->htsize; i++) {
+      chtab_entry *hi = atomic_load_explicit(&t->buckets[i], memory_order_relaxed);
+      while (hi) {
+         chtab_entry *next = atomic_load_explicit(&hi->nexth, memory_order_relaxed);
+         if (free_entry) {
+            free_entry(hi->key, hi->value);
+         }
+         free(hi);
+         hi = next;
+      }
+   }
+
+   free(t->buckets);
+   free(t);
+}
+
+chtab *
+chtab_create(void *fhash, void *fequals, void (*free_entry)(void *key, void *value)) {
+   chtab *ht = (chtab *)calloc(1, sizeof(chtab));
+   int i;
+
+   atomic_init(&ht->table, table_create(CH_HSIZE));
+   ht->hashfunc = fhash;
+   ht->eqfunc = fequals;
+   ht->free_entry = free_entry;
+
+   for (i=0; i < CH_STRIPES; i++) {
+      pthread_mutex_init(&ht->stripes[i], NULL);
+   }
+
+   pthread_mutex_init(&ht->reclaim, NULL);
+
+   return ht;
+}
+
+static void
+free_retired(chtab *ht, chtab_entry *e, chtab_table *t) {
+   uint32_t n = 0;
+
+   while (e) {
+      chtab_entry *next = e->retired;
+      if ((e->free_key || e->free_value) && ht->free_entry) {
+         ht->free_entry(e->free_key ? e->key : NULL, e->free_value ? e->value : NULL);
+      }
+      free(e);
+      e = next;
+      n++;
+   }
+
+   while (t) {
+      chtab_table *next = t->retired;
+      table_destroy(t, NULL);
+      t = next;
+   }
+
+   atomic_fetch_sub(&ht->nretired, n);
+}
+
+void
+chtab_destroy(chtab *ht) {
+   int i;
+
+   free_retired(ht, ht->pending, ht->pending_tables);
+   free_retired(ht, atomic_load(&ht->retired), atomic_load(&ht->retired_tables));
+   table_destroy(atomic_load(&ht->table), ht->free_entry);
+
+   for (i=0; i < CH_STRIPES; i++) {
+      pthread_mutex_destroy(&ht->stripes[i]);
+   }
+
+   pthread_mutex_destroy(&ht->reclaim);
+   free(ht);
+}
+
+int
+chtab_read_lock(chtab *ht) {
+   int idx;
+
+   if (reader_slot < 0) {
+      reader_slot = atomic_fetch_add(&next_reader, 1) % CH_READERS;
+   }
+
+   idx = atomic_load(&ht->epoch) & 1;
+   atomic_fetch_add(&ht->readers[idx][reader_slot].count, 1);
+
+   return idx * CH_READERS + reader_slot;
+}
+
+void
+chtab_read_unlock(chtab *ht, int token) {
+   atomic_fetch_sub(&ht->readers[token / CH_READERS][token % CH_READERS].count, 1);
+}
+
+static bool
+readers_active(chtab *ht, int idx) {
+   int s;
+
+   for (s=0; s < CH_READERS; s++) {
+      if (atomic_load(&ht->readers[idx][s].count) != 0) {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+/* Moves the grace period of the pending entries forward as far as the 
+ * readers allow, without waiting for them. A reader may have loaded the 
+ * epoch just before it was advanced and registered itself afterwards, so the
+ * epoch is advanced twice and both sets of counters have to drain before the
+ * pending entries can be freed. Returns true once they can be freed. */
+static bool
+grace_period(chtab *ht) {
+   for (;;) {
+      if (ht->gp_flips > 0 && readers_active(ht, ht->gp_old)) {
+         return false;
+      }
+      if (ht->gp_flips == 2) {
+         return true;
+      }
+      ht->gp_old = atomic_fetch_add(&ht->epoch, 1) & 1;
+      ht->gp_flips++;
+   }
+}
+
+/* Frees the retired entries whose readers have left. Never waits for a 
+ * reader: entries which might still be seen stay pending and are freed by a
+ * later call, so a long-lived reader only delays reclamation. */
+void
+chtab_reclaim(chtab *ht) {
+   int i;
+
+   if (pthread_mutex_trylock(&ht->reclaim) != 0) {
+      return;
+   }
+
+   /* Entries retired while a grace period was running need another one */
+   for (i=0; i < 2; i++) {
+      if (!ht->pending && !ht->pending_tables) {
+         ht->pending = atomic_exchange(&ht->retired, NULL);
+         ht->pending_tables = atomic_exchange(&ht->retired_tables, NULL);
+         ht->gp_flips = 0;
+      }
+
+      if ((!ht->pending && !ht->pending_tables) || !grace_period(ht)) {
+         break;
+      }
+
+      free_retired(ht, ht->pending, ht->pending_tables);
+      ht->pending = NULL;
+      ht->pending_tables = NULL;
+   }
+
+   pthread_mutex_unlock(&ht->reclaim);
+}
+
+/* Readers never look at the fields set here, so they may be written while
+ * the entry is still visible */
+static void
+retire_entry(chtab *ht, chtab_entry *e, bool free_key, bool free_value) {
+   e->free_key = free_key;
+   e->free_value = free_value;
+   e->retired = atomic_load(&ht->retired);
+   while (!atomic_compare_exchange_weak(&ht->retired, &e->retired, e));
+
+   if (atomic_fetch_add(&ht->nretired, 1) + 1 >= CH_RECLAIM) {
+      chtab_reclaim(ht);
+   }
+}
+
+static void
+retire_table(chtab *ht, chtab_table *t) {
+   t->retired = atomic_load(&ht->retired_tables);
+   while (!atomic_compare_exchange_weak(&ht->retired_tables, &t->retired, t));
+   chtab_reclaim(ht);
+}
+
+static inline chtab_entry *
+chtab_find_entry(chtab *ht, chtab_table *t, void *key, long hash) {
+   chtab_entry *hi;
+
+   hi = atomic_load_explicit(&t->buckets[hash & t->mask], memory_order_acquire);
+
+   for (; hi; hi=atomic_load_explicit(&hi->nexth, memory_order_acquire)) {
+      if (hi->hash == hash && ht->eqfunc(key, hi->key)) {
+         return hi;
+      }
+   }
+
+   return NULL;
+}
+
+void *
+chtab_get(chtab *ht, void *key) {
+   long hash = ht->hashfunc(key);
+   int token = chtab_read_lock(ht);
+   chtab_entry *entry;
+   void *value = NULL;
+
+   entry = chtab_find_entry(ht, atomic_load_explicit(&ht->table, memory_order_acquire), key, hash);
+
+   if (entry) {
+      value = entry->value;
+   }
+
+   chtab_read_unlock(ht, token);
+
+   return value;
+}
+
+bool
+chtab_contains(chtab *ht, void *key) {
+   if (chtab_get(ht, key) != NULL) {
+      return true;
+   }
+
+   return false;
+}
+
+/* Copies the entries into a new table, since readers may still walk the 
+ * chains of the old one */
+static void 
+rebuild_ht(chtab *ht) {
+   chtab_table *old, *t;
+   uint32_t i;
+
+   for (i=0; i < CH_STRIPES; i++) {
+      pthread_mutex_lock(&ht->stripes[i]);
+   }
+
+   old = atomic_load(&ht->table);
+
+   if (atomic_load(&ht->num) <= old->htsize * CH_REBUILD) {
+      /* Another writer already did it */
+      t = NULL;
+   } else {
+      t = table_create(old->htsize * CH_REBUILD);
+
+      for (i=0; i < old->htsize; i++) {
+         chtab_entry *hi = atomic_load_explicit(&old->buckets[i], memory_order_relaxed);
+
+         for (; hi; hi=atomic_load_explicit(&hi->nexth, memory_order_relaxed)) {
+            chtab_entry *entry = (chtab_entry *)calloc(1, sizeof(chtab_entry));
+            chtab_entry *_Atomic *bucket = &t->buckets[hi->hash & t->mask];
+            entry->key = hi->key;
+            entry->value = hi->value;
+            entry->hash = hi->hash;
+            atomic_store_explicit(&entry->nexth, atomic_load_explicit(bucket, memory_order_relaxed), memory_order_relaxed);
+            atomic_store_explicit(bucket, entry, memory_order_relaxed);
+         }
+      }
+
+      atomic_store_explicit(&ht->table, t, memory_order_release);
+   }
+
+   for (i=CH_STRIPES; i > 0; i--) {
+      pthread_mutex_unlock(&ht->stripes[i-1]);
+   }
+
+   if (t) {
+      retire_table(ht, old);
+   }
+}
+
+bool
+chtab_put(chtab *ht, void *key, void *value) {
+   long hash = ht->hashfunc(key);
+   pthread_mutex_t *stripe = &ht->stripes[hash & (CH_STRIPES - 1)];
+   chtab_entry *entry = (chtab_entry *)calloc(1, sizeof(chtab_entry));
+   chtab_entry *_Atomic *link;
+   chtab_entry *hi;
+   chtab_table *t;
+   bool grow = false;
+
+   entry->key = key;
+   entry->value = value;
+   entry->hash = hash;
+
+   pthread_mutex_lock(stripe);
+
+   /* The table can't be replaced while a stripe is locked */
+   t = atomic_load_explicit(&ht->table, memory_order_acquire);
+   link = &t->buckets[hash & t->mask];
+
+   for (hi=atomic_load(link); hi; link=&hi->nexth, hi=atomic_load(link)) {
+      if (hi->hash == hash && ht->eqfunc(key, hi->key)) {
+         break;
+      }
+   }
+
+   if (hi) {
+      atomic_store_explicit(&entry->nexth, atomic_load(&hi->nexth), memory_order_relaxed);
+      atomic_store_explicit(link, entry, memory_order_release);
+   } else {
+      link = &t->buckets[hash & t->mask];
+      atomic_store_explicit(&entry->nexth, atomic_load(link), memory_order_relaxed);
+      atomic_store_explicit(link, entry, memory_order_release);
+      grow = atomic_fetch_add(&ht->num, 1) + 1 > t->htsize * CH_REBUILD;
+   }
+
+   pthread_mutex_unlock(stripe);
+
+   /* Pointers which the new entry still holds are passed as NULL */
+   if (hi) {
+      retire_entry(ht, hi, hi->key != key, hi->value != value);
+   } else if (grow) {
+      rebuild_ht(ht);
+   }
+
+   return hi != NULL;
+}
+
+bool
+chtab_delete(chtab *ht, void *key) {
+   long hash = ht->hashfunc(key);
+   pthread_mutex_t *stripe = &ht->stripes[hash & (CH_STRIPES - 1)];
+   chtab_entry *_Atomic *link;
+   chtab_entry *hi;
+   chtab_table *t;
+
+   pthread_mutex_lock(stripe);
+
+   t = atomic_load_explicit(&ht->table, memory_order_acquire);
+   link = &t->buckets[hash & t->mask];
+
+   for (hi=atomic_load(link); hi; link=&hi->nexth, hi=atomic_load(link)) {
+      if (hi->hash == hash && ht->eqfunc(key, hi->key)) {
+         atomic_store_explicit(link, atomic_load(&hi->nexth), memory_order_release);
+         atomic_fetch_sub(&ht->num, 1);
+         break;
+      }
+   }
+
+   pthread_mutex_unlock(stripe);
+
+   if (hi) {
+      retire_entry(ht, hi, true, true);
+   }
+
+   return hi != NULL;
+}
+
+static inline chtab_entry *
+chtab_get_next_entry(chtab_it *it, chtab_entry *e) {
+   if (e) {
+      e = atomic_load_explicit(&e->nexth, memory_order_acquire);
+      if (e) {
+         return e;
+      }
+      it->bucket++;
+   }
+
+   for (; it->bucket < it->table->htsize; it->bucket++) {
+      e = atomic_load_explicit(&it->table->buckets[it->bucket], memory_order_acquire);
+      if (e) {
+         return e;
+      }
+   }
+
+   return NULL;
+}
+
+/* The iterator holds a read lock until it is destroyed */
+chtab_it *
+chtab_it_create(chtab *ht) {
+   chtab_it *it = (chtab_it *)calloc(1, sizeof(chtab_it));
+
+   if (ht) {
+      it->ht = ht;
+      it->token = chtab_read_lock(ht);
+      it->table = atomic_load_explicit(&ht->table, memory_order_acquire);
+      it->next = chtab_get_next_entry(it, NULL);
+   }
+
+   return it;
+}
+
+void
+chtab_it_destroy(chtab_it *it) {
+   if (it->ht) {
+      chtab_read_unlock(it->ht, it->token);
+   }
+
+   free(it);
+}
+
+bool
+chtab_it_has_next(chtab_it *it) {
+   return it->next != NULL;
+}
+
+chtab_entry *
+chtab_it_get_next(chtab_it *it) {
+   chtab_entry *e = it->next;
+
+   if (it->next) {
+      it->next = chtab_get_next_entry(it, it->next);
+   }
+
+   return e;
+}
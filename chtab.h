@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _CHTAB_H_
+#define _CHTAB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/*
+ * Concurrent hashtable. Readers never take a lock: they announce themselves
+ * in one of two reader counters and walk the chains. Writers lock one of 
+ * CH_STRIPES mutexes, chosen by the hash, and never modify an entry which 
+ * readers might see. A replaced or deleted entry is unlinked and only freed
+ * once all readers which might still see it have left. A resize takes all
+ * stripe locks, builds a new bucket array and publishes it atomically, so 
+ * readers keep working on the old one in the meantime.
+ *
+ * Entries removed from the table are passed to free_entry, as are the 
+ * entries left when the table is destroyed. A value returned by chtab_get is
+ * therefore only guaranteed to stay valid while the caller holds a read lock
+ * taken with chtab_read_lock. When chtab_put replaces an entry, a key or 
+ * value pointer which the new entry still holds is passed as NULL, and 
+ * free_entry isn't called at all if it holds both.
+ *
+ * Writers never wait for readers. Retired entries are freed by chtab_reclaim
+ * once every reader which might still see them has left, so a read lock or 
+ * an iterator held for a long time does not block writers, but keeps all 
+ * entries retired in the meantime in memory until it is released.
+ */
+
+#define CH_HSIZE     64 /* Initial size for the hashtable, >= CH_STRIPES */
+#define CH_STRIPES   64 /* Number of writer locks */
+#define CH_READERS   32 /* Number of reader counters per epoch */
+#define CH_REBUILD    2 /* Rebuild factor */
+#define CH_RECLAIM  256 /* Number of retired entries before reclaiming them */
+
+typedef struct chtab_entry {
+   void *value;                         /* Pointer to the data */
+   void *key;                           /* Hashkey */
+   long hash;                           /* Cached result of the hash function */
+   struct chtab_entry *_Atomic nexth;   /* Pointer to next chtab_entry */
+   struct chtab_entry *retired;         /* Next entry waiting to be freed */
+   bool free_key;                       /* Pass the key to free_entry when freed */
+   bool free_value;                     /* Pass the value to free_entry when freed */
+} chtab_entry;
+
+typedef struct chtab_table {
+   chtab_entry *_Atomic *buckets;       /* Array of pointers to chtab_entrys */
+   uint32_t htsize;                     /* Size of the table */
+   uint32_t mask;                       /* Ensure a key is smaller than the number of buckets */
+   struct chtab_table *retired;         /* Next table waiting to be freed */
+} chtab_table;
+
+typedef struct {
+   _Atomic long count;
+   char pad[64 - sizeof(long)];         /* Keep every counter on its own cache line */
+} chtab_readers;
+
+typedef struct chtab {
+   chtab_table *_Atomic table;          /* Current bucket array */
+   atomic_uint num;                     /* Number of entries */
+   atomic_uint epoch;                   /* Selects the reader counters new readers use */
+   chtab_readers readers[2][CH_READERS];
+   pthread_mutex_t stripes[CH_STRIPES];
+   chtab_entry *_Atomic retired;        /* Entries waiting to be freed */
+   chtab_table *_Atomic retired_tables; /* Tables waiting to be freed */
+   atomic_uint nretired;                /* Number of retired entries */
+   chtab_entry *pending;                /* Retired entries waiting for the grace period */
+   chtab_table *pending_tables;         /* Retired tables waiting for the grace period */
+   int gp_flips;                        /* Epoch advances done for the pending entries */
+   int gp_old;                          /* Reader counters which have to drain next */
+   pthread_mutex_t reclaim;             /* Serializes reclamation */
+   bool (*eqfunc)();                    /* Comperator function to find the matching entry */
+   long (*hashfunc)();                  /* Hash function to calculate the key */
+   void (*free_entry)(void *key, void *value); /* Called for entries removed from the table */
+} chtab;
+
+/* Holds a read lock until destroyed, which delays the reclamation of 
+ * retired entries */
+typedef struct {
+   chtab *ht;
+   chtab_table *table;
+   chtab_entry *next;
+   uint32_t bucket;
+   int token;
+} chtab_it;
+
+chtab *chtab_create(void *fhash, void *fequals, void (*free_entry)(void *key, void *value));
+void chtab_destroy(chtab *ht);
+int chtab_read_lock(chtab *ht);
+void chtab_read_unlock(chtab *ht, int token);
+void *chtab_get(chtab *ht, void *key);
+bool chtab_contains(chtab *ht, void *key);
+bool chtab_put(chtab *ht, void *key, void *value);
+bool chtab_delete(chtab *ht, void *key);
+void chtab_reclaim(chtab *ht);
+
+chtab_it *chtab_it_create(chtab *ht);
+void chtab_it_destroy(chtab_it *it);
+bool chtab_it_has_next(chtab_it *it);
+chtab_entry *chtab_it_get_next(chtab_it *it);
+
+#endif //_CHTAB_H_
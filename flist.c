@@ -0,0 +1,245 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "flist.h"
+
+flist *
+flist_create(int (*cmp_func)(void *, void *)) {
+   flist *l = (flist *)calloc(1, sizeof(flist));
+   l->cmp_func = cmp_func;
+   l->capacity = FL_SIZE;
+   l->values = (void **)calloc(l->capacity, sizeof(void *));
+   return l;
+}
+
+void
+flist_destroy(flist *l) {
+   free(l->values);
+   free(l);
+}
+
+inline bool
+flist_is_empty(flist *l) {
+   return l->size == 0;
+}
+
+inline u_int32_t
+flist_size(flist *l) {
+   return l->size;
+}
+
+inline void *
+flist_get(flist *l, u_int32_t index) {
+   return index < l->size ? l->values[l->start + index] : NULL;
+}
+
+/* Returns the index of the first value in [lo, hi) which isn't smaller 
+ * than value, or hi */
+static inline u_int32_t
+search(flist *l, void *value, u_int32_t lo, u_int32_t hi) {
+   void **v = &l->values[l->start];
+   u_int32_t mid;
+
+   while (lo < hi) {
+      mid = lo + (hi - lo) / 2;
+
+      if (l->cmp_func(value, v[mid]) > 0) {
+         lo = mid + 1;
+      } else {
+         hi = mid;
+      }
+   }
+
+   return lo;
+}
+
+/* Returns the index of the first value which isn't smaller than value */
+u_int32_t
+flist_lower_bound(flist *l, void *value) {
+   return search(l, value, 0, l->size);
+}
+
+/* Like flist_lower_bound, but searches from the end in steps of 1, 2, 4, 
+ * ... before the binary search, which is cheaper for values near the end */
+static u_int32_t
+gallop(flist *l, void *value) {
+   void **v = &l->values[l->start];
+   u_int32_t hi = l->size, step = 1;
+
+   while (hi > 0) {
+      u_int32_t probe = hi > step ? hi - step : 0;
+
+      if (l->cmp_func(value, v[probe]) > 0) {
+         return search(l, value, probe + 1, hi);
+      }
+
+      hi = probe;
+      step *= 2;
+   }
+
+   return 0;
+}
+
+/* Makes room for one more value at the end of the array */
+static void
+make_room(flist *l) {
+   if (l->start + l->size < l->capacity) {
+      return;
+   }
+
+   if (l->start >= l->capacity / 4) {
+      memmove(l->values, &l->values[l->start], l->size * sizeof(void *));
+      l->start = 0;
+   } else {
+      l->capacity *= 2;
+      l->values = (void **)realloc(l->values, l->capacity * sizeof(void *));
+   }
+}
+
+/* Inserts value before the first value which isn't smaller, so it's put in
+ * front of equal values. Returns the index of the value. */
+u_int32_t
+flist_insert(flist *l, void *value) {
+   u_int32_t i = gallop(l, value);
+
+   if (l->start > 0 && i < l->size / 2) {
+      memmove(&l->values[l->start - 1], &l->values[l->start], i * sizeof(void *));
+      l->start--;
+   } else {
+      make_room(l);
+      memmove(&l->values[l->start + i + 1], &l->values[l->start + i], (l->size - i) * sizeof(void *));
+   }
+
+   l->values[l->start + i] = value;
+   l->size++;
+
+   return i;
+}
+
+/* Removes the value at index and returns it, or NULL */
+void *
+flist_remove_at(flist *l, u_int32_t index) {
+   void *value;
+
+   if (index >= l->size) {
+      return NULL;
+   }
+
+   value = l->values[l->start + index];
+
+   if (index < l->size / 2) {
+      memmove(&l->values[l->start + 1], &l->values[l->start], index * sizeof(void *));
+      l->start++;
+   } else {
+      memmove(&l->values[l->start + index], &l->values[l->start + index + 1], 
+            (l->size - index - 1) * sizeof(void *));
+   }
+
+   if (--l->size == 0) {
+      l->start = 0;
+   }
+
+   return value;
+}
+
+void *
+flist_remove_first(flist *l) {
+   return flist_remove_at(l, 0);
+}
+
+void *
+flist_remove_last(flist *l) {
+   return flist_remove_at(l, l->size - 1);
+}
+
+/* Removes the first value which is equal to value */
+void *
+flist_remove(flist *l, void *value) {
+   u_int32_t i = flist_lower_bound(l, value);
+
+   if (i == l->size || l->cmp_func(value, l->values[l->start + i])) {
+      return NULL;
+   }
+
+   return flist_remove_at(l, i);
+}
+
+void
+flist_apply(flist *l, void(*f)(void *)) {
+   u_int32_t i;
+
+   for (i=0; i < l->size; i++) {
+      if (l->values[l->start + i]) {
+         f(l->values[l->start + i]);
+      }
+   }
+}
+
+flist_it *
+flist_it_create(flist *l) {
+   flist_it *it = (flist_it *)calloc(1, sizeof(flist_it));
+   if (l) {
+      it->l = l;
+      it->end = l->size;
+   }
+   return it;
+}
+
+/* Starts at the first value which isn't smaller than value */
+flist_it *
+flist_it_lower_bound(flist *l, void *value) {
+   flist_it *it = flist_it_create(l);
+
+   if (l) {
+      it->next = flist_lower_bound(l, value);
+   }
+
+   return it;
+}
+
+void
+flist_it_destroy(flist_it *it) {
+   free(it);
+}
+
+bool 
+flist_it_has_next(flist_it *it) {
+   return it->next < it->end;
+}
+
+void *
+flist_it_get_next(flist_it *it) {
+   if (flist_it_has_next(it)) {
+      return flist_get(it->l, it->next++);
+   }
+
+   return NULL;
+}
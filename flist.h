@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _FLIST_H_
+#define _FLIST_H_
+
+#include <sys/types.h>
+#include <stdbool.h>
+
+/*
+ * Flat ordered list. The values are kept in ascending order in one array,
+ * so a search is a binary search over adjacent pointers and the value at 
+ * an index is read in O(1). Inserting and removing move the shorter part
+ * of the array with memmove, the array has room at both ends for this. 
+ * Inserts search from the end of the array with galloping steps, so 
+ * appending ascending values, like timestamps, costs O(1) comparisons. 
+ * Values are ordered like in an olist, a value is inserted in front of 
+ * equal values and the first equal value is removed. Meant for lists of up 
+ * to some 10k values, larger ones should use an olist.
+ */
+
+#define FL_SIZE      16 /* Initial size of the array */
+
+typedef struct {
+   u_int32_t size;
+   u_int32_t start;                  /* Index of the first value in the array */
+   u_int32_t capacity;               /* Size of the array */
+   void **values;
+   int (*cmp_func)(void *, void *);
+} flist;
+
+typedef struct {
+   flist *l;
+   u_int32_t next;                   /* Index of the next value */
+   u_int32_t end;                    /* Index to stop at */
+} flist_it;
+
+flist *flist_create(int (*cmp_func)(void *, void *));
+void flist_destroy(flist *l);
+bool flist_is_empty(flist *l);
+u_int32_t flist_size(flist *l);
+u_int32_t flist_insert(flist *l, void *value);
+void *flist_get(flist *l, u_int32_t index);
+u_int32_t flist_lower_bound(flist *l, void *value);
+void *flist_remove_first(flist *l);
+void *flist_remove_last(flist *l);
+void *flist_remove(flist *l, void *value);
+void *flist_remove_at(flist *l, u_int32_t index);
+void flist_apply(flist *l, void(*f)(void *));
+
+flist_it *flist_it_create(flist *l);
+flist_it *flist_it_lower_bound(flist *l, void *value);
+void flist_it_destroy(flist_it *it);
+bool flist_it_has_next(flist_it *it);
+void *flist_it_get_next(flist_it *it);
+
+#endif //_FLIST_H_
@@ -0,0 +1,330 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ftab.h"
+#include "hash.h"
+
+typedef struct {
+   uint64_t mixed;             /* Hash mixed with the salt */
+   htab_entry *entry;
+} ftab_key;
+
+static inline uint32_t
+reduce(uint32_t x, uint32_t n) {
+   return ((uint64_t)x * n) >> 32;
+}
+
+static inline uint32_t
+ftab_bucket(ftab *f, uint64_t mixed) {
+   return reduce(mixed >> 32, f->nbuckets);
+}
+
+static inline uint32_t
+ftab_slot(ftab *f, uint64_t mixed, uint32_t pilot) {
+   return reduce(hash_u64(mixed ^ pilot, f->salt), f->size);
+}
+
+/* A key may be NULL, so empty slots are only told apart by the bitmap */
+static inline bool
+slot_used(ftab *f, uint32_t slot) {
+   return f->used[slot >> 6] & (1ULL << (slot & 63));
+}
+
+static int
+cmp_mixed(const void *a, const void *b) {
+   uint64_t x = ((ftab_key *)a)->mixed;
+   uint64_t y = ((ftab_key *)b)->mixed;
+
+   return x < y ? -1 : x > y;
+}
+
+/* 
+ * Searches a pilot for every bucket, the largest buckets first. Returns 
+ * false if a bucket has no pilot within FT_PILOTS tries.
+ */
+static bool
+place_keys(ftab *f, ftab_key *keys, uint32_t n) {
+   uint32_t *start = (uint32_t *)calloc(f->nbuckets + 1, sizeof(uint32_t));
+   uint32_t *order = (uint32_t *)calloc(f->nbuckets, sizeof(uint32_t));
+   uint32_t *slots = (uint32_t *)calloc(n, sizeof(uint32_t));
+   uint8_t *taken = (uint8_t *)calloc(f->size, sizeof(uint8_t));
+   uint32_t maxlen = 0, i, j, b, len, pilot;
+   uint32_t *bysize;
+   bool ok = true;
+
+   /* The keys are sorted by their mixed hash, so the keys of a bucket are 
+    * adjacent */
+   for (i=0; i < n; i++) {
+      start[ftab_bucket(f, keys[i].mixed) + 1]++;
+   }
+
+   for (b=0; b < f->nbuckets; b++) {
+      maxlen = start[b+1] > maxlen ? start[b+1] : maxlen;
+      start[b+1] += start[b];
+   }
+
+   /* Counting sort of the buckets by decreasing size */
+   bysize = (uint32_t *)calloc(maxlen + 2, sizeof(uint32_t));
+   for (b=0; b < f->nbuckets; b++) {
+      bysize[maxlen - (start[b+1] - start[b]) + 1]++;
+   }
+   for (i=0; i <= maxlen; i++) {
+      bysize[i+1] += bysize[i];
+   }
+   for (b=0; b < f->nbuckets; b++) {
+      order[bysize[maxlen - (start[b+1] - start[b])]++] = b;
+   }
+
+   for (i=0; i < f->nbuckets && ok; i++) {
+      b = order[i];
+      len = start[b+1] - start[b];
+
+      if (len == 0) {
+         break;
+      }
+
+      for (pilot=0; pilot < FT_PILOTS; pilot++) {
+         for (j=0; j < len; j++) {
+            slots[j] = ftab_slot(f, keys[start[b]+j].mixed, pilot);
+
+            if (taken[slots[j]]) {
+               break;
+            }
+
+            taken[slots[j]] = 1;
+         }
+
+         if (j == len) {
+            break;
+         }
+
+         /* Release the slots of this try */
+         while (j-- > 0) {
+            taken[slots[j]] = 0;
+         }
+      }
+
+      if (pilot == FT_PILOTS) {
+         ok = false;
+         break;
+      }
+
+      f->pilots[b] = pilot;
+      for (j=0; j < len; j++) {
+         htab_entry *e = keys[start[b]+j].entry;
+
+         f->slots[slots[j]].key = e->key;
+         f->slots[slots[j]].value = e->value;
+         f->slots[slots[j]].hash = e->hash;
+         f->used[slots[j] >> 6] |= 1ULL << (slots[j] & 63);
+      }
+   }
+
+   free(start);
+   free(order);
+   free(slots);
+   free(taken);
+   free(bysize);
+
+   return ok;
+}
+
+/* Builds a frozen copy of the entries of ht. ht can be destroyed 
+ * afterwards, as long as its keys and values aren't freed. */
+ftab *
+ftab_freeze(htab *ht) {
+   ftab *f = (ftab *)calloc(1, sizeof(ftab));
+   ftab_key *keys = (ftab_key *)calloc(ht->num ? ht->num : 1, sizeof(ftab_key));
+   htab_entry **entries = (htab_entry **)calloc(ht->num ? ht->num : 1, sizeof(htab_entry *));
+   htab_it *it = htab_it_create(ht);
+   uint32_t n = 0, i, unique;
+
+   f->eqfunc = ht->eqfunc;
+   f->hashfunc = ht->hashfunc;
+   f->seeded_hashfunc = ht->seeded_hashfunc;
+   f->seed = ht->seed;
+   f->num = ht->num;
+   f->size = (uint64_t)ht->num * 100 / FT_LOAD + 1;
+   f->nbuckets = ht->num / FT_BUCKET + 1;
+   f->pilots = (uint32_t *)calloc(f->nbuckets, sizeof(uint32_t));
+
+   while (htab_it_has_next(it)) {
+      entries[n++] = htab_it_get_next(it);
+   }
+   htab_it_destroy(it);
+
+   for (f->salt=hash_seed(); ; f->salt++) {
+      /* keys is compacted below, so every try starts from all entries */
+      for (i=0; i < n; i++) {
+         keys[i].entry = entries[i];
+         keys[i].mixed = hash_u64(entries[i]->hash, f->salt);
+      }
+
+      qsort(keys, n, sizeof(ftab_key), cmp_mixed);
+
+      /* No pilot separates keys with the same hash, they are moved into 
+       * the overflow array and found by a scan */
+      free(f->overflow);
+      f->overflow = NULL;
+      f->noverflow = 0;
+      for (i=1, unique=n ? 1 : 0; i < n; i++) {
+         if (keys[i].entry->hash == keys[unique-1].entry->hash) {
+            f->overflow = (ftab_entry *)realloc(f->overflow, (f->noverflow + 1) * sizeof(ftab_entry));
+            f->overflow[f->noverflow].key = keys[i].entry->key;
+            f->overflow[f->noverflow].value = keys[i].entry->value;
+            f->overflow[f->noverflow].hash = keys[i].entry->hash;
+            f->noverflow++;
+         } else {
+            keys[unique++] = keys[i];
+         }
+      }
+
+      free(f->slots);
+      f->slots = (ftab_entry *)calloc(f->size, sizeof(ftab_entry));
+      free(f->used);
+      f->used = (uint64_t *)calloc((f->size + 63) / 64, sizeof(uint64_t));
+
+      if (place_keys(f, keys, unique)) {
+         break;
+      }
+   }
+
+   free(keys);
+   free(entries);
+
+   return f;
+}
+
+void
+ftab_destroy(ftab *f) {
+   free(f->slots);
+   free(f->used);
+   free(f->pilots);
+   free(f->overflow);
+   free(f);
+}
+
+inline uint32_t
+ftab_size(ftab *f) {
+   return f->num;
+}
+
+static inline long
+ftab_hash(ftab *f, void *key) {
+   if (f->seeded_hashfunc) {
+      return f->seeded_hashfunc(key, f->seed);
+   }
+
+   return f->hashfunc(key);
+}
+
+void *
+ftab_get(ftab *f, void *key) {
+   long hash = ftab_hash(f, key);
+   uint64_t mixed = hash_u64(hash, f->salt);
+   uint32_t slot = ftab_slot(f, mixed, f->pilots[ftab_bucket(f, mixed)]);
+   ftab_entry *e = &f->slots[slot];
+   uint32_t i;
+
+   if (!slot_used(f, slot) || e->hash != hash) {
+      return NULL;
+   }
+
+   if (f->eqfunc(key, e->key)) {
+      return e->value;
+   }
+
+   for (i=0; i < f->noverflow; i++) {
+      if (f->overflow[i].hash == hash && f->eqfunc(key, f->overflow[i].key)) {
+         return f->overflow[i].value;
+      }
+   }
+
+   return NULL;
+}
+
+bool
+ftab_contains(ftab *f, void *key) {
+   if (ftab_get(f, key) != NULL) {
+      return true;
+   }
+
+   return false;
+}
+
+/* Iterates the slots first and then the overflow array */
+static inline uint32_t
+next_used(ftab *f, uint32_t pos) {
+   while (pos < f->size && !slot_used(f, pos)) {
+      pos++;
+   }
+
+   return pos;
+}
+
+ftab_it *
+ftab_it_create(ftab *f) {
+   ftab_it *it = (ftab_it *)calloc(1, sizeof(ftab_it));
+
+   if (f) {
+      it->f = f;
+      it->pos = next_used(f, 0);
+   }
+
+   return it;
+}
+
+void
+ftab_it_destroy(ftab_it *it) {
+   free(it);
+}
+
+bool
+ftab_it_has_next(ftab_it *it) {
+   return it->f && it->pos < it->f->size + it->f->noverflow;
+}
+
+ftab_entry *
+ftab_it_get_next(ftab_it *it) {
+   ftab_entry *e;
+
+   if (!ftab_it_has_next(it)) {
+      return NULL;
+   }
+
+   if (it->pos < it->f->size) {
+      e = &it->f->slots[it->pos];
+      it->pos = next_used(it->f, it->pos + 1);
+   } else {
+      e = &it->f->overflow[it->pos++ - it->f->size];
+   }
+
+   return e;
+}
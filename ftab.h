@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _FTAB_H_
+#define _FTAB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "htab.h"
+
+/*
+ * Frozen hashtable. ftab_freeze copies the entries of a htab into a single
+ * array which is addressed by a perfect hash in the style of CHD/PTHash: 
+ * the hash of a key selects a bucket of about FT_BUCKET keys, and the 
+ * pilot of that bucket is mixed into the hash again to select the slot. 
+ * The pilots are searched at build time, so that no two keys share a slot.
+ * A lookup costs one call of the hash function and one probe, without 
+ * chains. The table can't be changed and is safe to read from several 
+ * threads. Keys and values are shared with the htab.
+ */
+
+#define FT_BUCKET    4  /* Average number of keys per bucket */
+#define FT_LOAD      95 /* Percentage of used slots */
+#ifndef FT_PILOTS
+#define FT_PILOTS    (1<<16) /* Pilots tried per bucket before a new salt is chosen */
+#endif
+
+typedef struct {
+   void *key;
+   void *value;
+   long hash;                  /* Result of the hash function */
+} ftab_entry;
+
+typedef struct ftab {
+   ftab_entry *slots;          /* Array of slots */
+   uint64_t *used;             /* One bit per slot, set if the slot holds an entry */
+   uint32_t *pilots;           /* Pilot of every bucket */
+   ftab_entry *overflow;       /* Entries whose hash equals the hash of another entry */
+   uint32_t num;               /* Number of entries */
+   uint32_t size;              /* Number of slots */
+   uint32_t nbuckets;          /* Number of buckets */
+   uint32_t noverflow;         /* Number of entries in overflow */
+   uint64_t salt;              /* Seed for mixing the hashes */
+   bool (*eqfunc)();           /* Comperator function to find the matching key */
+   long (*hashfunc)();         /* Hash function to calculate the key */
+   long (*seeded_hashfunc)(void *key, uint64_t seed); /* Used instead of hashfunc if set */
+   uint64_t seed;              /* Seed for seeded_hashfunc */
+} ftab;
+
+typedef struct {
+   ftab *f;
+   uint32_t pos;
+} ftab_it;
+
+ftab *ftab_freeze(htab *ht);
+void ftab_destroy(ftab *f);
+uint32_t ftab_size(ftab *f);
+void *ftab_get(ftab *f, void *key);
+bool ftab_contains(ftab *f, void *key);
+
+ftab_it *ftab_it_create(ftab *f);
+void ftab_it_destroy(ftab_it *it);
+bool ftab_it_has_next(ftab_it *it);
+ftab_entry *ftab_it_get_next(ftab_it *it);
+
+#endif //_FTAB_H_
@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/random.h>
+
+#include "hash.h"
+
+static const uint64_t secret[4] = {
+   0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 
+   0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+};
+
+static inline void
+mum(uint64_t *a, uint64_t *b) {
+   __uint128_t r = *a;
+   r *= *b;
+   *a = (uint64_t)r;
+   *b = (uint64_t)(r >> 64);
+}
+
+static inline uint64_t
+mix(uint64_t a, uint64_t b) {
+   mum(&a, &b);
+   return a ^ b;
+}
+
+static inline uint64_t
+read64(const uint8_t *p) {
+   uint64_t v;
+   memcpy(&v, p, 8);
+   return v;
+}
+
+static inline uint64_t
+read32(const uint8_t *p) {
+   uint32_t v;
+   memcpy(&v, p, 4);
+   return v;
+}
+
+uint64_t
+hash_seed(void) {
+   uint64_t seed;
+
+   if (getrandom(&seed, sizeof(seed), GRND_NONBLOCK) != sizeof(seed)) {
+      seed = mix((uint64_t)time(NULL) ^ secret[0], 
+                 ((uint64_t)getpid() << 32) ^ (uint64_t)(uintptr_t)&seed);
+   }
+
+   return seed;
+}
+
+uint64_t
+hash_bytes(const void *data, size_t len, uint64_t seed) {
+   const uint8_t *p = (const uint8_t *)data;
+   uint64_t a, b;
+
+   seed ^= mix(seed ^ secret[0], secret[1]);
+
+   if (len <= 16) {
+      if (len >= 4) {
+         a = (read32(p) << 32) | read32(p + ((len >> 3) << 2));
+         b = (read32(p + len - 4) << 32) | read32(p + len - 4 - ((len >> 3) << 2));
+      } else if (len > 0) {
+         a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+         b = 0;
+      } else {
+         a = b = 0;
+      }
+   } else {
+      size_t i = len;
+
+      if (i >= 48) {
+         uint64_t see1 = seed, see2 = seed;
+
+         do {
+            seed = mix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+            see1 = mix(read64(p + 16) ^ secret[2], read64(p + 24) ^ see1);
+            see2 = mix(read64(p + 32) ^ secret[3], read64(p + 40) ^ see2);
+            p += 48;
+            i -= 48;
+         } while (i >= 48);
+
+         seed ^= see1 ^ see2;
+      }
+
+      while (i > 16) {
+         seed = mix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+         i -= 16;
+         p += 16;
+      }
+
+      a = read64(p + i - 16);
+      b = read64(p + i - 8);
+   }
+
+   a ^= secret[1];
+   b ^= seed;
+   mum(&a, &b);
+
+   return mix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+uint64_t
+hash_u64(uint64_t value, uint64_t seed) {
+   return mix(value ^ secret[0], seed ^ secret[1]);
+}
+
+long
+hash_key_string(void *key, uint64_t seed) {
+   return (long)hash_bytes(key, strlen((const char *)key), seed);
+}
+
+long
+hash_key_span(void *key, uint64_t seed) {
+   hash_span *span = (hash_span *)key;
+   return (long)hash_bytes(span->data, span->len, seed);
+}
+
+long
+hash_key_int32(void *key, uint64_t seed) {
+   return (long)hash_u64((uint32_t)*(int32_t *)key, seed);
+}
+
+long
+hash_key_int64(void *key, uint64_t seed) {
+   return (long)hash_u64((uint64_t)*(int64_t *)key, seed);
+}
+
+bool
+hash_equals_string(void *a, void *b) {
+   return strcmp((const char *)a, (const char *)b) == 0;
+}
+
+bool
+hash_equals_span(void *a, void *b) {
+   hash_span *sa = (hash_span *)a, *sb = (hash_span *)b;
+   return sa->len == sb->len && memcmp(sa->data, sb->data, sa->len) == 0;
+}
+
+bool
+hash_equals_int32(void *a, void *b) {
+   return *(int32_t *)a == *(int32_t *)b;
+}
+
+bool
+hash_equals_int64(void *a, void *b) {
+   return *(int64_t *)a == *(int64_t *)b;
+}
@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _HASH_H_
+#define _HASH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Seeded hash and equality functions for common key types. The hash over
+ * byte strings follows wyhash. A table should use its own random seed from
+ * hash_seed, so that colliding keys can't be precomputed.
+ */
+
+typedef struct {
+   const void *data;
+   size_t len;
+} hash_span;
+
+uint64_t hash_seed(void);
+uint64_t hash_bytes(const void *data, size_t len, uint64_t seed);
+uint64_t hash_u64(uint64_t value, uint64_t seed);
+
+/* Hash functions taking a pointer to the key */
+long hash_key_string(void *key, uint64_t seed);  /* NUL-terminated string */
+long hash_key_span(void *key, uint64_t seed);    /* hash_span */
+long hash_key_int32(void *key, uint64_t seed);   /* int32_t */
+long hash_key_int64(void *key, uint64_t seed);   /* int64_t */
+
+bool hash_equals_string(void *a, void *b);
+bool hash_equals_span(void *a, void *b);
+bool hash_equals_int32(void *a, void *b);
+bool hash_equals_int64(void *a, void *b);
+
+#endif //_HASH_H_
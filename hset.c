@@ -0,0 +1,330 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hash.h"
+#include "hset.h"
+
+#define CTRL_EMPTY   0x00 /* Slot has never been used */
+#define CTRL_DELETED 0x01 /* Slot contained a key which has been removed */
+#define CTRL_FULL    0x80 /* Set in the control byte of every used slot */
+
+static inline uint64_t
+hset_hash(hset *s, void *key) {
+   if (s->seeded_hashfunc) {
+      return (uint64_t)s->seeded_hashfunc(key, s->seed);
+   }
+
+   /* Spread the bits of the user supplied hash */
+   return hash_u64((uint64_t)s->hashfunc(key), 0);
+}
+
+static inline uint8_t
+hset_tag(uint64_t h) {
+   return CTRL_FULL | (h >> 57);
+}
+
+static void
+alloc_slots(hset *s, uint32_t size) {
+   s->htsize = size;
+   s->mask = size - 1;
+   s->maxent = size - size / 4;
+   s->deleted = 0;
+   s->ctrl = (uint8_t *)calloc(size, sizeof(uint8_t));
+   s->keys = (void **)calloc(size, sizeof(void *));
+}
+
+hset *
+hset_create(void *fhash, void *fequals) {
+   hset *s = (hset *)calloc(1, sizeof(hset));
+   s->hashfunc = fhash;
+   s->eqfunc = fequals;
+   alloc_slots(s, HS_HSIZE);
+   return s;
+}
+
+hset *
+hset_create_with(htab_key_type type) {
+   hset *s;
+
+   switch (type) {
+      case HTAB_KEY_STRING:
+         s = hset_create(NULL, hash_equals_string);
+         s->seeded_hashfunc = hash_key_string;
+         break;
+      case HTAB_KEY_SPAN:
+         s = hset_create(NULL, hash_equals_span);
+         s->seeded_hashfunc = hash_key_span;
+         break;
+      case HTAB_KEY_INT32:
+         s = hset_create(NULL, hash_equals_int32);
+         s->seeded_hashfunc = hash_key_int32;
+         break;
+      case HTAB_KEY_INT64:
+         s = hset_create(NULL, hash_equals_int64);
+         s->seeded_hashfunc = hash_key_int64;
+         break;
+      default:
+         return NULL;
+   }
+
+   s->seed = hash_seed();
+   return s;
+}
+
+/* Creates an empty set with the functions and seed of s */
+static hset *
+hset_create_like(hset *s) {
+   hset *n = hset_create(s->hashfunc, s->eqfunc);
+   n->seeded_hashfunc = s->seeded_hashfunc;
+   n->seed = s->seed;
+   return n;
+}
+
+void
+hset_destroy(hset *s) {
+   free(s->ctrl);
+   free(s->keys);
+   free(s);
+}
+
+inline uint32_t
+hset_size(hset *s) {
+   return s->num;
+}
+
+static inline int64_t
+find_slot(hset *s, void *key, uint64_t h) {
+   uint32_t pos = h & s->mask;
+   uint8_t tag = hset_tag(h);
+
+   while (s->ctrl[pos] != CTRL_EMPTY) {
+      if (s->ctrl[pos] == tag && s->eqfunc(key, s->keys[pos])) {
+         return pos;
+      }
+      pos = (pos + 1) & s->mask;
+   }
+
+   return -1;
+}
+
+bool
+hset_contains(hset *s, void *key) {
+   return find_slot(s, key, hset_hash(s, key)) >= 0;
+}
+
+/* Hashes and prefetches the keys in chunks, so the cache misses overlap */
+void
+hset_contains_many(hset *s, void **keys, bool *results, uint32_t n) {
+   uint64_t hashes[BATCH];
+   uint32_t i, j, len;
+
+   for (i=0; i < n; i+=len) {
+      len = n - i < BATCH ? n - i : BATCH;
+
+      for (j=0; j < len; j++) {
+         hashes[j] = hset_hash(s, keys[i+j]);
+         __builtin_prefetch(&s->ctrl[hashes[j] & s->mask]);
+         __builtin_prefetch(&s->keys[hashes[j] & s->mask]);
+      }
+
+      for (j=0; j < len; j++) {
+         results[i+j] = find_slot(s, keys[i+j], hashes[j]) >= 0;
+      }
+   }
+}
+
+/* Inserts a key which is known not to be in the set */
+static inline void
+hset_insert(hset *s, void *key, uint64_t h) {
+   uint32_t pos = h & s->mask;
+
+   while (s->ctrl[pos] & CTRL_FULL) {
+      pos = (pos + 1) & s->mask;
+   }
+
+   if (s->ctrl[pos] == CTRL_DELETED) {
+      s->deleted--;
+   }
+
+   s->ctrl[pos] = hset_tag(h);
+   s->keys[pos] = key;
+   s->num++;
+}
+
+static void
+rebuild_set(hset *s, uint32_t size) {
+   uint8_t *oldctrl = s->ctrl;
+   void **oldkeys = s->keys;
+   uint32_t oldsize = s->htsize;
+   uint32_t i;
+
+   alloc_slots(s, size);
+   s->num = 0;
+
+   for (i=0; i < oldsize; i++) {
+      if (oldctrl[i] & CTRL_FULL) {
+         hset_insert(s, oldkeys[i], hset_hash(s, oldkeys[i]));
+      }
+   }
+
+   free(oldctrl);
+   free(oldkeys);
+}
+
+/* Returns false if the key was already in the set */
+bool
+hset_add(hset *s, void *key) {
+   uint64_t h = hset_hash(s, key);
+
+   if (find_slot(s, key, h) >= 0) {
+      return false;
+   }
+
+   if (s->num + s->deleted + 1 >= s->maxent) {
+      /* Reclaim the tombstones if they make up a large part of the set */
+      rebuild_set(s, s->num < s->maxent / 2 ? s->htsize : s->htsize * 2);
+   }
+
+   hset_insert(s, key, h);
+
+   return true;
+}
+
+bool
+hset_remove(hset *s, void *key) {
+   int64_t pos = find_slot(s, key, hset_hash(s, key));
+
+   if (pos < 0) {
+      return false;
+   }
+
+   s->ctrl[pos] = CTRL_DELETED;
+   s->keys[pos] = NULL;
+   s->deleted++;
+   s->num--;
+
+   return true;
+}
+
+hset *
+hset_union(hset *a, hset *b) {
+   hset *u = hset_create_like(a);
+   uint32_t i;
+
+   for (i=0; i < a->htsize; i++) {
+      if (a->ctrl[i] & CTRL_FULL) {
+         hset_add(u, a->keys[i]);
+      }
+   }
+
+   for (i=0; i < b->htsize; i++) {
+      if (b->ctrl[i] & CTRL_FULL) {
+         hset_add(u, b->keys[i]);
+      }
+   }
+
+   return u;
+}
+
+hset *
+hset_intersection(hset *a, hset *b) {
+   hset *n = hset_create_like(a);
+   hset *small = a->num < b->num ? a : b;
+   hset *large = small == a ? b : a;
+   uint32_t i;
+
+   /* Probe the larger set with the keys of the smaller one */
+   for (i=0; i < small->htsize; i++) {
+      if ((small->ctrl[i] & CTRL_FULL) && hset_contains(large, small->keys[i])) {
+         hset_add(n, small->keys[i]);
+      }
+   }
+
+   return n;
+}
+
+hset *
+hset_difference(hset *a, hset *b) {
+   hset *n = hset_create_like(a);
+   uint32_t i;
+
+   for (i=0; i < a->htsize; i++) {
+      if ((a->ctrl[i] & CTRL_FULL) && !hset_contains(b, a->keys[i])) {
+         hset_add(n, a->keys[i]);
+      }
+   }
+
+   return n;
+}
+
+static inline uint32_t
+next_full(hset *s, uint32_t pos) {
+   while (pos < s->htsize && !(s->ctrl[pos] & CTRL_FULL)) {
+      pos++;
+   }
+
+   return pos;
+}
+
+hset_it *
+hset_it_create(hset *s) {
+   hset_it *it = (hset_it *)calloc(1, sizeof(hset_it));
+
+   if (s) {
+      it->s = s;
+      it->pos = next_full(s, 0);
+   }
+
+   return it;
+}
+
+void
+hset_it_destroy(hset_it *it) {
+   free(it);
+}
+
+bool
+hset_it_has_next(hset_it *it) {
+   return it->s && it->pos < it->s->htsize;
+}
+
+void *
+hset_it_get_next(hset_it *it) {
+   void *key;
+
+   if (!hset_it_has_next(it)) {
+      return NULL;
+   }
+
+   key = it->s->keys[it->pos];
+   it->pos = next_full(it->s, it->pos + 1);
+
+   return key;
+}
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _HSET_H_
+#define _HSET_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "htab.h"
+
+/*
+ * Hash set. Only the keys are stored, in an open addressing array next to
+ * an array of control bytes which carry 7 bits of the hash of every key, so
+ * a set needs about 9 bytes per slot and no allocation per key. Sets are
+ * created from the same hash and equality functions as htab, or with the
+ * built-in ones of hash.h. The set operations require both sets to use
+ * the same functions and create a new set like the first one.
+ */
+
+#define HS_HSIZE     16 /* Initial size for the set, a power of 2 */
+
+typedef struct hset {
+   uint8_t *ctrl;              /* Control bytes, one per slot */
+   void **keys;                /* Array of slots */
+   uint32_t num;               /* Number of keys */
+   uint32_t deleted;           /* Number of tombstones */
+   uint32_t maxent;            /* Maximum number of used slots before rebuild */
+   uint32_t htsize;            /* Number of slots */
+   uint32_t mask;              /* Ensure an index is within the set */
+   bool (*eqfunc)();           /* Comperator function to find the matching key */
+   long (*hashfunc)();         /* Hash function to calculate the key */
+   long (*seeded_hashfunc)(void *key, uint64_t seed); /* Used instead of hashfunc if set */
+   uint64_t seed;              /* Seed for seeded_hashfunc */
+} hset;
+
+typedef struct {
+   hset *s;
+   uint32_t pos;
+} hset_it;
+
+hset *hset_create(void *fhash, void *fequals);
+hset *hset_create_with(htab_key_type type);
+void hset_destroy(hset *s);
+uint32_t hset_size(hset *s);
+bool hset_contains(hset *s, void *key);
+void hset_contains_many(hset *s, void **keys, bool *results, uint32_t n);
+bool hset_add(hset *s, void *key);
+bool hset_remove(hset *s, void *key);
+hset *hset_union(hset *a, hset *b);
+hset *hset_intersection(hset *a, hset *b);
+hset *hset_difference(hset *a, hset *b);
+
+hset_it *hset_it_create(hset *s);
+void hset_it_destroy(hset_it *it);
+bool hset_it_has_next(hset_it *it);
+void *hset_it_get_next(hset_it *it);
+
+#endif //_HSET_H_
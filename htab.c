@@ -28,59 +28,339 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
 
+#include "hash.h"
 #include "htab.h"
 
+/* Hot path counters, only maintained if compiled with -DHTAB_STATS */
+#ifdef HTAB_STATS
+#define HTAB_COUNT(ht, counter) ((ht)->counter++)
+#else
+#define HTAB_COUNT(ht, counter)
+#endif
+
+/*
+ * A rebuild allocates the new bucket array and leaves the entries in the 
+ * old one. Every subsequent operation moves MIGRATE old buckets over, so the
+ * cost of the rebuild is spread across many calls. As long as a bucket 
+ * has not been migrated, its keys are looked up and inserted in the old 
+ * array, so every key always lives in exactly one chain. Only operations 
+ * which modify the table migrate, lookups never change it.
+ */
+
+/* Returns the smallest table size which holds n entries without a rebuild */
+static inline uint32_t
+htab_size_for(uint32_t n) {
+   uint32_t size = HSIZE;
+
+   while (size * REBUILD <= n) {
+      size <<= 1;
+   }
+
+   return size;
+}
+
 htab * 
 htab_create(void *fhash, void *fequals) {
+  return htab_create_sized(fhash, fequals, 0);
+}
+
+/* Creates a table which holds n entries without a rebuild. It isn't shrunk
+ * below that size when entries are deleted. */
+htab *
+htab_create_sized(void *fhash, void *fequals, uint32_t n) {
   htab *ht = (htab *)calloc(1, sizeof(htab));
   ht->num = 0;
-  ht->maxent = HSIZE * REBUILD;
-  ht->mask = HSIZE - 1;
-  ht->htsize = HSIZE;
+  ht->htsize = htab_size_for(n);
+  ht->minsize = ht->htsize;
+  ht->maxent = ht->htsize * REBUILD;
+  ht->mask = ht->htsize - 1;
   ht->hashfunc = fhash;
   ht->eqfunc = fequals;
   ht->buckets = (htab_entry **)calloc(ht->htsize, sizeof(htab_entry*)); 
   return ht;
 }
 
-void 
-htab_destroy(htab *ht) {
+/* Creates a table using the built-in functions for the given key type and
+ * a random seed */
+htab *
+htab_create_with(htab_key_type type) {
+   htab *ht;
+
+   switch (type) {
+      case HTAB_KEY_STRING:
+         ht = htab_create(NULL, hash_equals_string);
+         ht->seeded_hashfunc = hash_key_string;
+         break;
+      case HTAB_KEY_SPAN:
+         ht = htab_create(NULL, hash_equals_span);
+         ht->seeded_hashfunc = hash_key_span;
+         break;
+      case HTAB_KEY_INT32:
+         ht = htab_create(NULL, hash_equals_int32);
+         ht->seeded_hashfunc = hash_key_int32;
+         break;
+      case HTAB_KEY_INT64:
+         ht = htab_create(NULL, hash_equals_int64);
+         ht->seeded_hashfunc = hash_key_int64;
+         break;
+      default:
+         return NULL;
+   }
+
+   ht->seed = hash_seed();
+   return ht;
+}
+
+static inline long
+htab_hash(htab *ht, void *key) {
+   if (ht->seeded_hashfunc) {
+      return ht->seeded_hashfunc(key, ht->seed);
+   }
+
+   return ht->hashfunc(key);
+}
+
+static void
+free_buckets(htab_entry **buckets, uint32_t size, void (*free_entry)(htab_entry *entry)) {
    uint32_t i;
 
-   for (i=0; i < ht->htsize; i++) {
-      if (ht->buckets[i] != NULL) {
-         htab_entry *hi = ht->buckets[i];
+   for (i=0; i < size; i++) {
+      if (buckets[i] != NULL) {
+         htab_entry *hi = buckets[i];
          while (hi) {
             htab_entry *next = hi->nexth;
+            if (free_entry) {
+               free_entry(hi);
+            }
             free(hi);
             hi = next; 
          }
       }
    }
 
-   free(ht->buckets);
+   free(buckets);
+}
+
+static void
+free_filters(htab *ht) {
+   if (ht->filter) {
+      bloom_destroy(ht->filter);
+      ht->filter = NULL;
+   }
+
+   if (ht->oldfilter) {
+      bloom_destroy(ht->oldfilter);
+      ht->oldfilter = NULL;
+   }
+}
+
+void 
+htab_destroy(htab *ht) {
+   if (ht->oldbuckets) {
+      free_buckets(ht->oldbuckets, ht->oldsize, NULL);
+   }
+
+   free_buckets(ht->buckets, ht->htsize, NULL);
+   free_filters(ht);
    free(ht);
 }
 
 void
 htab_destroy_free(htab *ht, void (*free_entry)(htab_entry *entry)) {
+   if (ht->oldbuckets) {
+      free_buckets(ht->oldbuckets, ht->oldsize, free_entry);
+   }
+
+   free_buckets(ht->buckets, ht->htsize, free_entry);
+   free_filters(ht);
+   free(ht);
+}
+
+static inline uint64_t
+htab_now_ns(void) {
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void
+filter_add_chains(bloom *filter, htab_entry **buckets, uint32_t from, uint32_t to) {
+   htab_entry *hi;
    uint32_t i;
 
-   for (i=0; i < ht->htsize; i++) {
-      if (ht->buckets[i] != NULL) {
-         htab_entry *hi = ht->buckets[i];
-         while (hi) {
-            htab_entry *next = hi->nexth;
-            free_entry(hi);
-            free(hi);
-            hi = next; 
+   for (i=from; i < to; i++) {
+      for (hi=buckets[i]; hi; hi=hi->nexth) {
+         bloom_add(filter, hi->hash);
+      }
+   }
+}
+
+/* Refills the filter from the cached hashes of all entries */
+static void
+htab_filter_fill(htab *ht) {
+   bloom_clear(ht->filter);
+   filter_add_chains(ht->filter, ht->buckets, 0, ht->htsize);
+
+   if (ht->oldbuckets) {
+      filter_add_chains(ht->filter, ht->oldbuckets, ht->migrated, ht->oldsize);
+   }
+
+   ht->filter_stale = 0;
+}
+
+/* Called once the old buckets are empty */
+static void
+migrate_done(htab *ht) {
+   free(ht->oldbuckets);
+   ht->oldbuckets = NULL;
+
+   if (ht->oldfilter) {
+      bloom_destroy(ht->oldfilter);
+      ht->oldfilter = NULL;
+   }
+}
+
+static void
+migrate_buckets(htab *ht, uint32_t n) {
+   uint32_t empty_visits = n * 10;
+   htab_entry **oldbptr;
+   htab_entry *hi;
+
+   while (n > 0 && ht->migrated < ht->oldsize) {
+      oldbptr = &ht->oldbuckets[ht->migrated++];
+
+      if (*oldbptr == NULL) {
+         /* Bound the work done on a sparse table as well */
+         if (--empty_visits == 0) {
+            break;
          }
+         continue;
       }
+
+      for (hi=*oldbptr; hi != NULL; hi=*oldbptr) {
+         *oldbptr = hi->nexth;
+         hi->fstbuck = &(ht->buckets[hi->hash & ht->mask]);
+         HTAB_COUNT(ht, hash_saved);
+         hi->nexth = *hi->fstbuck;
+         *hi->fstbuck = hi;
+
+         if (ht->filter) {
+            bloom_add(ht->filter, hi->hash);
+         }
+      }
+
+      n--;
    }
 
-   free(ht->buckets);
-   free(ht);
+   if (ht->migrated >= ht->oldsize) {
+      migrate_done(ht);
+   }
+}
+
+typedef struct {
+   htab *ht;
+   void *arg;                   /* Passed through by htab_parallel */
+   uint32_t t;                  /* Number of the partition */
+   uint32_t from;               /* Start of the partition */
+   uint32_t to;                 /* End of the partition */
+} htab_part;
+
+/* Migrates all old buckets whose index modulo the smaller of the two sizes
+ * lies in the partition. The entries of these buckets end up in new buckets
+ * with the same residue, so the partitions don't share any bucket. */
+static void *
+migrate_part(void *arg) {
+   htab_part *part = (htab_part *)arg;
+   htab *ht = part->ht;
+   uint32_t small = ht->oldsize < ht->htsize ? ht->oldsize : ht->htsize;
+   uint32_t r, j;
+   htab_entry *hi;
+
+   for (r=part->from; r < part->to; r++) {
+      for (j=r; j < ht->oldsize; j+=small) {
+         for (hi=ht->oldbuckets[j]; hi != NULL; hi=ht->oldbuckets[j]) {
+            ht->oldbuckets[j] = hi->nexth;
+            hi->fstbuck = &(ht->buckets[hi->hash & ht->mask]);
+            hi->nexth = *hi->fstbuck;
+            *hi->fstbuck = hi;
+         }
+      }
+   }
+
+   return NULL;
+}
+
+/* Runs f on nthreads partitions of [0, n) */
+static void
+htab_parallel(htab *ht, uint32_t n, uint32_t nthreads, void *(*f)(void *), void *arg) {
+   pthread_t *threads = (pthread_t *)calloc(nthreads, sizeof(pthread_t));
+   htab_part *parts = (htab_part *)calloc(nthreads, sizeof(htab_part));
+   uint32_t t;
+
+   for (t=0; t < nthreads; t++) {
+      parts[t].ht = ht;
+      parts[t].arg = arg;
+      parts[t].t = t;
+      parts[t].from = (uint64_t)n * t / nthreads;
+      parts[t].to = (uint64_t)n * (t + 1) / nthreads;
+
+      if (t == nthreads - 1 || pthread_create(&threads[t], NULL, f, &parts[t]) != 0) {
+         /* Run the last partition, or one without a thread, on this one */
+         f(&parts[t]);
+         threads[t] = pthread_self();
+      }
+   }
+
+   for (t=0; t < nthreads; t++) {
+      if (!pthread_equal(threads[t], pthread_self())) {
+         pthread_join(threads[t], NULL);
+      }
+   }
+
+   free(threads);
+   free(parts);
+}
+
+/* Completes a migration, in parallel if the table is large enough */
+static void
+migrate_all(htab *ht) {
+   uint32_t small = ht->oldsize < ht->htsize ? ht->oldsize : ht->htsize;
+   uint64_t start = htab_now_ns();
+
+   if (ht->threads > 1 && small >= PARALLEL) {
+      htab_parallel(ht, small, ht->threads, migrate_part, NULL);
+      migrate_done(ht);
+      ht->migrated = ht->oldsize;
+
+      /* The threads don't share the filter, so it's filled afterwards */
+      if (ht->filter) {
+         htab_filter_fill(ht);
+      }
+#ifdef HTAB_STATS
+      ht->hash_saved += ht->num;
+#endif
+   } else {
+      migrate_buckets(ht, ht->oldsize);
+   }
+
+   ht->rebuild_ns += htab_now_ns() - start;
+}
+
+static inline htab_entry **
+htab_get_bucket(htab *ht, long hash) {
+   if (ht->oldbuckets) {
+      uint32_t i = hash & ht->oldmask;
+
+      if (i >= ht->migrated) {
+         return &ht->oldbuckets[i];
+      }
+   }
+
+   return &ht->buckets[hash & ht->mask];
 }
 
 void *
@@ -94,11 +374,16 @@ htab_get(htab *ht, void *key) {
    return NULL;
 }
 
-htab_entry *
-htab_get_entry(htab *ht, void *key) {
-   register htab_entry *hi;
+static inline htab_entry *
+htab_find_in_chain(htab *ht, htab_entry *hi, void *key, long hash) {
+   for (; hi; hi=hi->nexth) {
+      if (hi->hash != hash) {
+         HTAB_COUNT(ht, eq_saved);
+         continue;
+      }
+
+      HTAB_COUNT(ht, eq_calls);
 
-   for (hi=ht->buckets[ht->hashfunc(key) & ht->mask]; hi; hi=hi->nexth) {
       if (ht->eqfunc(key, hi->key)) {
          return hi;
       }
@@ -107,6 +392,39 @@ htab_get_entry(htab *ht, void *key) {
    return NULL;
 }
 
+/* Returns true if the filter rules out the hash */
+static inline bool
+htab_filter_miss(htab *ht, long hash) {
+   if (!ht->filter || bloom_maybe_contains(ht->filter, hash) || 
+         (ht->oldfilter && bloom_maybe_contains(ht->oldfilter, hash))) {
+      return false;
+   }
+
+   HTAB_COUNT(ht, filtered);
+   return true;
+}
+
+static inline htab_entry *
+htab_find_entry(htab *ht, void *key, long hash) {
+   if (htab_filter_miss(ht, hash)) {
+      return NULL;
+   }
+
+   return htab_find_in_chain(ht, *htab_get_bucket(ht, hash), key, hash);
+}
+
+htab_entry *
+htab_get_entry(htab *ht, void *key) {
+   htab_entry *entry = htab_find_entry(ht, key, htab_hash(ht, key));
+
+   HTAB_COUNT(ht, gets);
+   if (entry) {
+      HTAB_COUNT(ht, hits);
+   }
+
+   return entry;
+}
+
 bool
 htab_contains(htab *ht, void *key) {
    if (htab_get(ht, key) != NULL) {
@@ -116,48 +434,352 @@ htab_contains(htab *ht, void *key) {
    return false;
 }
 
+/* Starts migrating the entries into a new bucket array of the given size, 
+ * which must be a power of 2. Open iterators may still walk the old buckets
+ * of a running migration, so a rebuild which would have to complete it is 
+ * deferred until the last iterator is destroyed. */
 static void 
-rebuild_ht(htab *ht, int growth_factor) {
-   htab_entry **oldbuck = ht->buckets;
-   htab_entry **oldbptr;
-   htab_entry *hi;     
-   int oldsize = ht->htsize;
+rebuild_ht(htab *ht, uint32_t size) {
+   uint64_t start;
 
-   ht->htsize *= growth_factor;
+   if (ht->oldbuckets) {
+      if (ht->iterators > 0) {
+         return;
+      }
+      migrate_all(ht);
+   }
+
+   start = htab_now_ns();
+
+   ht->oldbuckets = ht->buckets;
+   ht->oldsize = ht->htsize;
+   ht->oldmask = ht->mask;
+   ht->migrated = 0;
+
+   ht->htsize = size;
    ht->mask = ht->htsize - 1;
-   ht->maxent = ht->htsize * growth_factor;
+   ht->maxent = ht->htsize * REBUILD;
    ht->buckets = (htab_entry **)calloc(ht->htsize, sizeof(htab_entry *));
+   ht->rebuilds++;
 
-   /* Rehash the old values */
-   for (oldbptr=oldbuck; 0<oldsize--; oldbptr++) {
-      for (hi=*oldbptr; hi != NULL; hi=*oldbptr) {
-         *oldbptr = hi->nexth;
-         hi->fstbuck = &(ht->buckets[ht->hashfunc(hi->key) & ht->mask]);
-         hi->nexth = *hi->fstbuck;
-         *hi->fstbuck = hi;
+   /* The new filter is filled as the entries are migrated, until then the 
+    * old one covers the entries left in the old buckets */
+   if (ht->filter) {
+      ht->oldfilter = ht->filter;
+      ht->filter = bloom_create(ht->maxent, ht->filter_bits);
+      ht->filter_stale = 0;
+   }
+
+   ht->rebuild_ns += htab_now_ns() - start;
+
+   /* A table which rebuilds in parallel is migrated right away */
+   if (ht->threads > 1 && ht->oldsize >= PARALLEL && ht->htsize >= PARALLEL && 
+         ht->iterators == 0) {
+      migrate_all(ht);
+   }
+}
+
+/* Makes room for n more entries */
+static inline void
+htab_grow(htab *ht, uint32_t n) {
+   if (ht->num+n >= ht->maxent) {
+      uint32_t size = ht->htsize;
+      uint32_t needed = htab_size_for(ht->num + n);
+
+      /* Keep the size a power of 2, so the mask covers all buckets */
+      while (size < ht->htsize * REBUILD) {
+         size <<= 1;
       }
+
+      rebuild_ht(ht, size > needed ? size : needed);
    }
+}
 
-   free(oldbuck);
+/* Shrinks the table once less than 1/SHRINK of the buckets would be used. 
+ * The table grows at REBUILD entries per bucket, so there's a wide margin 
+ * between the two and a table doesn't oscillate between sizes. */
+static inline void
+htab_maybe_shrink(htab *ht) {
+   if (ht->num * SHRINK < ht->htsize && ht->htsize > ht->minsize && 
+         !ht->oldbuckets && ht->iterators == 0) {
+      uint32_t size = htab_size_for(ht->num * REBUILD);
+
+      rebuild_ht(ht, size > ht->minsize ? size : ht->minsize);
+   }
+}
+
+/* Moves a running migration forward, or starts a rebuild which was 
+ * deferred while iterators were open */
+static inline void
+migrate_step(htab *ht) {
+   if (ht->iterators > 0) {
+      return;
+   }
+
+   if (ht->oldbuckets) {
+#ifdef HTAB_STATS
+      /* Two clock reads would cost more than a step, so they're only timed 
+       * along with the other counters */
+      uint64_t start = htab_now_ns();
+
+      migrate_buckets(ht, MIGRATE);
+      ht->rebuild_ns += htab_now_ns() - start;
+#else
+      migrate_buckets(ht, MIGRATE);
+#endif
+
+      /* A shrink is skipped during a migration, so it's checked again 
+       * once the migration is done */
+      if (!ht->oldbuckets) {
+         htab_maybe_shrink(ht);
+      }
+   } else if (ht->htsize < ht->minsize) {
+      rebuild_ht(ht, ht->minsize);
+   }
 }
 
 void
 htab_rehash(htab *ht) {
-   rebuild_ht(ht, 1);
+   rebuild_ht(ht, ht->htsize);
+   if (ht->oldbuckets && ht->iterators == 0) {
+      migrate_all(ht);
+   }
 }
 
-htab_entry * 
-htab_put(htab *ht, void *key, void *value) {
-   if (ht->num+1 >= ht->maxent) {
-      rebuild_ht(ht, REBUILD);
+/* Makes room for n entries in total. The table isn't shrunk below that 
+ * size when entries are deleted. */
+void
+htab_reserve(htab *ht, uint32_t n) {
+   ht->minsize = htab_size_for(n);
+
+   if (ht->minsize > ht->htsize) {
+      rebuild_ht(ht, ht->minsize);
+   }
+}
+
+/* Shrinks the table to the smallest size which holds the current entries 
+ * and drops a size set by htab_create_sized or htab_reserve */
+void
+htab_shrink_to_fit(htab *ht) {
+   ht->minsize = HSIZE;
+   rebuild_ht(ht, htab_size_for(ht->num));
+   if (ht->oldbuckets && ht->iterators == 0) {
+      migrate_all(ht);
+   }
+}
+
+/* Rebuilds of tables with at least PARALLEL buckets use this many threads */
+void
+htab_set_threads(htab *ht, uint32_t threads) {
+   ht->threads = threads;
+}
+
+/* 
+ * Puts a blocked Bloom filter of bits_per_key bits per entry in front of the
+ * lookups, so most lookups of missing keys don't walk a chain. The filter 
+ * is sized for the current size of the table and rebuilt with it. 0 
+ * removes the filter.
+ */
+void
+htab_set_filter(htab *ht, uint32_t bits_per_key) {
+   free_filters(ht);
+   ht->filter_bits = bits_per_key;
+
+   if (bits_per_key > 0) {
+      ht->filter = bloom_create(ht->num > ht->maxent ? ht->num : ht->maxent, bits_per_key);
+      htab_filter_fill(ht);
+   }
+}
+
+typedef struct {
+   htab *ht;
+   void **keys;
+   void **values;
+   uint32_t n;
+   uint32_t nthreads;
+   long *hashes;
+   uint32_t *order;             /* Indexes of the keys grouped by partition */
+   uint32_t *counts;            /* nthreads x nthreads counters */
+   uint32_t *inserted;          /* Entries inserted per partition */
+} htab_build;
+
+static inline uint32_t
+build_partition(htab_build *b, long hash) {
+   return ((uint64_t)(hash & b->ht->mask) * b->nthreads) >> __builtin_ctz(b->ht->htsize);
+}
+
+/* Hashes a range of the keys and counts them per partition */
+static void *
+build_hash(void *arg) {
+   htab_part *part = (htab_part *)arg;
+   htab_build *b = (htab_build *)part->arg;
+   uint32_t *counts = &b->counts[part->t * b->nthreads];
+   uint32_t i;
+
+   for (i=part->from; i < part->to; i++) {
+      b->hashes[i] = htab_hash(b->ht, b->keys[i]);
+      counts[build_partition(b, b->hashes[i])]++;
+   }
+
+   return NULL;
+}
+
+/* Copies the indexes of a range of the keys into their partition */
+static void *
+build_scatter(void *arg) {
+   htab_part *part = (htab_part *)arg;
+   htab_build *b = (htab_build *)part->arg;
+   uint32_t *counts = &b->counts[part->t * b->nthreads];
+   uint32_t i;
+
+   for (i=part->from; i < part->to; i++) {
+      b->order[counts[build_partition(b, b->hashes[i])]++] = i;
+   }
+
+   return NULL;
+}
+
+/* Links the entries of one partition. Only this thread touches the buckets
+ * of the partition, so no locking is needed. */
+static void *
+build_link(void *arg) {
+   htab_part *part = (htab_part *)arg;
+   htab_build *b = (htab_build *)part->arg;
+   htab *ht = b->ht;
+   uint32_t p = part->t, k, from, to;
+
+   from = p == 0 ? 0 : b->counts[(b->nthreads - 1) * b->nthreads + p - 1];
+   to = b->counts[(b->nthreads - 1) * b->nthreads + p];
+
+   for (k=from; k < to; k++) {
+      uint32_t i = b->order[k];
+      long hash = b->hashes[i];
+      htab_entry **bucket = &ht->buckets[hash & ht->mask];
+      htab_entry *hi;
+
+      for (hi=*bucket; hi; hi=hi->nexth) {
+         if (hi->hash == hash && ht->eqfunc(b->keys[i], hi->key)) {
+            break;
+         }
+      }
+
+      /* Later duplicates replace earlier ones, as with htab_put */
+      if (hi) {
+         hi->key = b->keys[i];
+         hi->value = b->values[i];
+         continue;
+      }
+
+      hi = (htab_entry *)calloc(1, sizeof(htab_entry));
+      hi->key = b->keys[i];
+      hi->value = b->values[i];
+      hi->hash = hash;
+      hi->fstbuck = bucket;
+      hi->nexth = *bucket;
+      *bucket = hi;
+      b->inserted[p]++;
    }
 
+   return NULL;
+}
+
+/* Creates a table sized for n entries and fills it from the arrays using 
+ * nthreads threads. The keys are hashed in parallel and grouped into one 
+ * partition of buckets per thread, which is then linked by that thread. 
+ * Unlike htab_create_sized, the size isn't kept as a minimum. */
+htab *
+htab_build_from_arrays(void *fhash, void *fequals, void **keys, void **values, 
+      uint32_t n, uint32_t nthreads) {
+   htab *ht = htab_create_sized(fhash, fequals, n);
+   htab_build b;
+   uint32_t t, p, sum;
+
+   if (nthreads == 0) {
+      nthreads = 1;
+   }
+
+   if (nthreads > n) {
+      nthreads = n ? n : 1;
+   }
+
+   ht->threads = nthreads;
+
+   memset(&b, 0, sizeof(b));
+   b.ht = ht;
+   b.keys = keys;
+   b.values = values;
+   b.n = n;
+   b.nthreads = nthreads;
+   b.hashes = (long *)malloc((n ? n : 1) * sizeof(long));
+   b.order = (uint32_t *)malloc((n ? n : 1) * sizeof(uint32_t));
+   b.counts = (uint32_t *)calloc(nthreads * nthreads, sizeof(uint32_t));
+   b.inserted = (uint32_t *)calloc(nthreads, sizeof(uint32_t));
+
+   if (n > 0) {
+      htab_parallel(ht, n, nthreads, build_hash, &b);
+
+      /* Turn the counters into start offsets, ordered by partition and 
+       * then by thread, which keeps the keys of a partition in order */
+      for (sum=0, p=0; p < nthreads; p++) {
+         for (t=0; t < nthreads; t++) {
+            uint32_t c = b.counts[t * nthreads + p];
+            b.counts[t * nthreads + p] = sum;
+            sum += c;
+         }
+      }
+
+      htab_parallel(ht, n, nthreads, build_scatter, &b);
+
+      /* The counters of the last thread now hold the end of every partition */
+      htab_parallel(ht, nthreads, nthreads, build_link, &b);
+   }
+
+   for (p=0; p < nthreads; p++) {
+      ht->num += b.inserted[p];
+   }
+
+   /* The size only avoids rebuilds during the build, later deletes may 
+    * shrink the table like one created by htab_create */
+   ht->minsize = HSIZE;
+
+   free(b.hashes);
+   free(b.order);
+   free(b.counts);
+   free(b.inserted);
+
+   return ht;
+}
+
+/* Links a new entry for a key which is known not to be in the chain */
+static inline htab_entry *
+htab_link(htab *ht, htab_entry **bucket, void *key, void *value, long hash) {
    htab_entry *entry = (htab_entry *)calloc(1, sizeof(htab_entry));
-   htab_entry *existing = htab_get_entry(ht, key);
+
+   ht->num++;
+   entry->key = key;
+   entry->value = value;
+   entry->hash = hash;
+   entry->fstbuck = bucket;
+   entry->nexth = *entry->fstbuck;
+   *entry->fstbuck = entry;
+
+   if (ht->filter) {
+      bloom_add(ht->filter, hash);
+   }
+
+   return entry;
+}
+
+static htab_entry *
+htab_insert(htab *ht, htab_entry **bucket, void *key, void *value, long hash) {
+   htab_entry *entry;
+   htab_entry *existing = htab_find_in_chain(ht, *bucket, key, hash);
 
    if (existing) {
+      entry = (htab_entry *)calloc(1, sizeof(htab_entry));
       entry->key = existing->key;
       entry->value = existing->value;
+      entry->hash = existing->hash;
       entry->fstbuck = NULL;
       entry->nexth = NULL;
 
@@ -166,21 +788,23 @@ htab_put(htab *ht, void *key, void *value) {
 
       return entry;
    } else {
-      ht->num++;
-      entry->key = key;
-      entry->value = value;
-      entry->fstbuck = &(ht->buckets[ht->hashfunc(key) & ht->mask]);
-      entry->nexth = *entry->fstbuck;
-      *entry->fstbuck = entry;
+      htab_link(ht, bucket, key, value, hash);
       return NULL;
    }
 }
 
-htab_entry *
-htab_delete(htab *ht, void *key) {
+static htab_entry *
+htab_remove(htab *ht, htab_entry **bucket, void *key, long hash) {
    htab_entry *hi, *last_hi = NULL;
 
-   for (hi=ht->buckets[ht->hashfunc(key) & ht->mask]; hi; last_hi=hi, hi=hi->nexth) {
+   for (hi=*bucket; hi; last_hi=hi, hi=hi->nexth) {
+      if (hi->hash != hash) {
+         HTAB_COUNT(ht, eq_saved);
+         continue;
+      }
+
+      HTAB_COUNT(ht, eq_calls);
+
       if (ht->eqfunc(key, hi->key)) {
          if (last_hi) {
             last_hi->nexth = hi->nexth;
@@ -189,6 +813,13 @@ htab_delete(htab *ht, void *key) {
          } 
 
          ht->num--;
+
+         /* A Bloom filter can't forget a key, so it's refilled once it 
+          * holds more deleted keys than live ones */
+         if (ht->filter && ++ht->filter_stale > ht->num && !ht->oldbuckets) {
+            htab_filter_fill(ht);
+         }
+
          return hi;
       }
    }
@@ -196,27 +827,225 @@ htab_delete(htab *ht, void *key) {
    return NULL;
 }
 
+htab_entry * 
+htab_put(htab *ht, void *key, void *value) {
+   htab_grow(ht, 1);
+
+   long hash = htab_hash(ht, key);
+
+   migrate_step(ht);
+
+   return htab_insert(ht, htab_get_bucket(ht, hash), key, value, hash);
+}
+
+htab_entry *
+htab_delete(htab *ht, void *key) {
+   long hash = htab_hash(ht, key);
+   htab_entry *entry;
+
+   migrate_step(ht);
+   entry = htab_remove(ht, htab_get_bucket(ht, hash), key, hash);
+
+   if (entry) {
+      htab_maybe_shrink(ht);
+   }
+
+   return entry;
+}
+
+/* 
+ * Returns a pointer to the value slot of the key, which stays valid until the
+ * entry is deleted. If the key isn't in the table yet, an entry with a NULL 
+ * value is inserted and inserted is set to true. The key is hashed once and 
+ * its chain is walked once, and an entry is only allocated if one is 
+ * inserted.
+ */
+void **
+htab_find_or_insert(htab *ht, void *key, bool *inserted) {
+   htab_entry **bucket, *entry;
+   long hash;
+
+   htab_grow(ht, 1);
+   hash = htab_hash(ht, key);
+   migrate_step(ht);
+
+   bucket = htab_get_bucket(ht, hash);
+   entry = htab_find_in_chain(ht, *bucket, key, hash);
+
+   if (inserted) {
+      *inserted = entry == NULL;
+   }
+
+   if (!entry) {
+      entry = htab_link(ht, bucket, key, NULL, hash);
+   }
+
+   return &entry->value;
+}
+
+/* 
+ * Replaces the value of the key with the result of update, which is called 
+ * with the current value, or NULL if the key isn't in the table. Returns the
+ * new value.
+ */
+void *
+htab_update(htab *ht, void *key, void *(*update)(void *key, void *value, void *arg), void *arg) {
+   void **slot = htab_find_or_insert(ht, key, NULL);
+
+   *slot = update(key, *slot, arg);
+
+   return *slot;
+}
+
+/* 
+ * The batch functions work on chunks of BATCH keys. All keys of a chunk are
+ * hashed and their buckets and first entries are prefetched before the 
+ * first key is resolved, so the cache misses of the chunk overlap. The 
+ * table is neither migrated nor grown within a chunk, which keeps the 
+ * bucket pointers valid.
+ */
+static inline void
+htab_prefetch_batch(htab *ht, void **keys, uint32_t n, long *hashes, htab_entry ***buckets) {
+   uint32_t i;
+
+   for (i=0; i < n; i++) {
+      hashes[i] = htab_hash(ht, keys[i]);
+      buckets[i] = htab_get_bucket(ht, hashes[i]);
+      __builtin_prefetch(buckets[i]);
+   }
+
+   for (i=0; i < n; i++) {
+      if (*buckets[i]) {
+         __builtin_prefetch(*buckets[i]);
+      }
+   }
+}
+
+void
+htab_get_many(htab *ht, void **keys, void **values, uint32_t n) {
+   long hashes[BATCH];
+   htab_entry **buckets[BATCH];
+   uint32_t i, j, len;
+
+   for (i=0; i < n; i+=len) {
+      len = n - i < BATCH ? n - i : BATCH;
+
+      htab_prefetch_batch(ht, &keys[i], len, hashes, buckets);
+
+      for (j=0; j < len; j++) {
+         htab_entry *entry = htab_filter_miss(ht, hashes[j]) ? NULL :
+               htab_find_in_chain(ht, *buckets[j], keys[i+j], hashes[j]);
+         values[i+j] = entry ? entry->value : NULL;
+
+         HTAB_COUNT(ht, gets);
+         if (entry) {
+            HTAB_COUNT(ht, hits);
+         }
+      }
+   }
+}
+
+/* Replaced entries are stored in replaced, or destroyed if it is NULL. 
+ * Returns the number of new entries. */
+uint32_t
+htab_put_many(htab *ht, void **keys, void **values, uint32_t n, htab_entry **replaced) {
+   long hashes[BATCH];
+   htab_entry **buckets[BATCH];
+   uint32_t i, j, len, inserted = 0;
+
+   for (i=0; i < n; i+=len) {
+      len = n - i < BATCH ? n - i : BATCH;
+
+      htab_grow(ht, len);
+
+      migrate_step(ht);
+      htab_prefetch_batch(ht, &keys[i], len, hashes, buckets);
+
+      for (j=0; j < len; j++) {
+         htab_entry *old = htab_insert(ht, buckets[j], keys[i+j], values[i+j], hashes[j]);
+
+         if (!old) {
+            inserted++;
+         }
+
+         if (replaced) {
+            replaced[i+j] = old;
+         } else if (old) {
+            htab_entry_destroy(old);
+         }
+      }
+   }
+
+   return inserted;
+}
+
+/* Deleted entries are stored in deleted, or destroyed if it is NULL. 
+ * Returns the number of deleted entries. */
+uint32_t
+htab_delete_many(htab *ht, void **keys, uint32_t n, htab_entry **deleted) {
+   long hashes[BATCH];
+   htab_entry **buckets[BATCH];
+   uint32_t i, j, len, removed = 0;
+
+   for (i=0; i < n; i+=len) {
+      len = n - i < BATCH ? n - i : BATCH;
+
+      migrate_step(ht);
+      htab_prefetch_batch(ht, &keys[i], len, hashes, buckets);
+
+      for (j=0; j < len; j++) {
+         htab_entry *old = htab_remove(ht, buckets[j], keys[i+j], hashes[j]);
+
+         if (old) {
+            removed++;
+         }
+
+         if (deleted) {
+            deleted[i+j] = old;
+         } else if (old) {
+            htab_entry_destroy(old);
+         }
+      }
+   }
+
+   htab_maybe_shrink(ht);
+
+   return removed;
+}
+
 void 
 htab_entry_destroy(htab_entry *entry) {
    free(entry);
 }
 
+/* Iterates over the old buckets first, if there are any, and the new 
+ * buckets afterwards */
 static inline htab_entry *
-htab_get_next_entry(htab *ht, htab_entry ***bucket, htab_entry *e) {
-   if (!e && **bucket) {
-      return **bucket;
-   } else if(!**bucket || !e->nexth) {
-      if (*bucket < &ht->buckets[ht->htsize-1]) {
-         do {
-            (*bucket)++; 
-         } while(**bucket == NULL && *bucket < &ht->buckets[ht->htsize-1]);
-         return **bucket;
-      }
+htab_get_next_entry(htab_it *it, htab_entry *e) {
+   htab *ht = it->ht;
 
-      return NULL;
+   if (e) {
+      if (e->nexth) {
+         return e->nexth;
+      }
+      it->bucket++;
    }
 
-   return e->nexth;
+   for (;;) {
+      while (it->bucket < it->end) {
+         if (*it->bucket) {
+            return *it->bucket;
+         }
+         it->bucket++;
+      }
+
+      if (it->end == &ht->buckets[ht->htsize]) {
+         return NULL;
+      }
+
+      it->bucket = ht->buckets;
+      it->end = &ht->buckets[ht->htsize];
+   }
 }
 
 
@@ -226,8 +1055,17 @@ htab_it_create(htab *ht) {
 
    if (ht) {
       it->ht = ht; 
-      it->bucket = ht->buckets;
-      it->next = htab_get_next_entry(ht, &it->bucket, NULL);
+      ht->iterators++;
+
+      if (ht->oldbuckets) {
+         it->bucket = &ht->oldbuckets[ht->migrated];
+         it->end = &ht->oldbuckets[ht->oldsize];
+      } else {
+         it->bucket = ht->buckets;
+         it->end = &ht->buckets[ht->htsize];
+      }
+
+      it->next = htab_get_next_entry(it, NULL);
    }
 
    return it;
@@ -235,6 +1073,10 @@ htab_it_create(htab *ht) {
 
 inline void 
 htab_it_destroy(htab_it *it) {
+   if (it->ht) {
+      it->ht->iterators--;
+   }
+
    free(it);
 }
 
@@ -248,21 +1090,88 @@ htab_it_get_next(htab_it *it) {
    htab_entry *e = it->next;
 
    if (it->next) {
-      it->next = htab_get_next_entry(it->ht, &it->bucket, it->next);
+      it->next = htab_get_next_entry(it, it->next);
    }
 
    return e;
 }
 
+/* Fills in the counters which are available without scanning the table */
+static void
+htab_counters(htab *ht, htab_stats *stats) {
+   memset(stats, 0, sizeof(htab_stats));
+   stats->num = ht->num;
+   stats->htsize = ht->htsize;
+   stats->load_factor = (double)ht->num / ht->htsize;
+   stats->rebuilds = ht->rebuilds;
+   stats->rebuild_ns = ht->rebuild_ns;
+   stats->rebuilding = ht->oldbuckets != NULL;
+   stats->bucket_bytes = (uint64_t)ht->htsize * sizeof(htab_entry *);
+   if (ht->oldbuckets) {
+      stats->bucket_bytes += (uint64_t)ht->oldsize * sizeof(htab_entry *);
+   }
+   stats->entry_bytes = (uint64_t)ht->num * sizeof(htab_entry);
+   stats->hash_saved = ht->hash_saved;
+   stats->eq_saved = ht->eq_saved;
+   stats->gets = ht->gets;
+   stats->hits = ht->hits;
+   stats->eq_calls = ht->eq_calls;
+   stats->filtered = ht->filtered;
+   if (ht->filter) {
+      stats->filter_bytes = (uint64_t)ht->filter->nblocks * BLOOM_BLOCK * sizeof(uint64_t);
+   }
+   if (ht->oldfilter) {
+      stats->filter_bytes += (uint64_t)ht->oldfilter->nblocks * BLOOM_BLOCK * sizeof(uint64_t);
+   }
+}
+
+static void
+chain_stats(htab_entry **buckets, uint32_t from, uint32_t size, htab_stats *stats) {
+   uint32_t i, len;
+   htab_entry *hi;
+
+   for (i=from; i < size; i++) {
+      for (len=0, hi=buckets[i]; hi; hi=hi->nexth) {
+         len++;
+      }
+
+      stats->chains[len < HTAB_HIST ? len : HTAB_HIST - 1]++;
+
+      if (len > stats->max_chain) {
+         stats->max_chain = len;
+      }
+   }
+}
+
+/* Returns the statistics of the table. If scan is set, the chains are 
+ * walked to fill in the chain length histogram, otherwise only counters 
+ * are read and the call is O(1). */
 void
-htab_print_state(htab *ht) {
+htab_get_stats(htab *ht, htab_stats *stats, bool scan) {
+   htab_counters(ht, stats);
+
+   if (scan) {
+      uint32_t nbuckets = ht->htsize;
+
+      if (ht->oldbuckets) {
+         chain_stats(ht->oldbuckets, ht->migrated, ht->oldsize, stats);
+         nbuckets += ht->oldsize - ht->migrated;
+      }
+
+      chain_stats(ht->buckets, 0, ht->htsize, stats);
+      stats->empty_ratio = (double)stats->chains[0] / nbuckets;
+   }
+}
+
+static void
+print_buckets(htab_entry **buckets, uint32_t size) {
    uint32_t i;
 
-   for (i=0; i < ht->htsize; i++) {
-      printf("<%p>: %-5u ", &ht->buckets[i], i);
-      if (ht->buckets[i] != NULL) {
+   for (i=0; i < size; i++) {
+      printf("<%p>: %-5u ", &buckets[i], i);
+      if (buckets[i] != NULL) {
          htab_entry *hi;
-         for (hi=ht->buckets[i]; hi; hi=hi->nexth) {
+         for (hi=buckets[i]; hi; hi=hi->nexth) {
             printf(" %p(%p,%p)", hi, hi->key, hi->value);
          }
       }
@@ -270,3 +1179,11 @@ htab_print_state(htab *ht) {
    }
 }
 
+void
+htab_print_state(htab *ht) {
+   if (ht->oldbuckets) {
+      print_buckets(ht->oldbuckets, ht->oldsize);
+   }
+
+   print_buckets(ht->buckets, ht->htsize);
+}
@@ -31,34 +31,104 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#define HSIZE     16 /* Initial size for the hashtable */
+#include "bloom.h"
+
+#define HSIZE     16 /* Initial size for the hashtable, a power of 2 */
 #define REBUILD    3 /* Rebuild factor */
+#define SHRINK     4 /* Shrink when less than 1/SHRINK of the buckets would be used */
+#define MIGRATE    1 /* Number of buckets migrated per operation during a rebuild */
+#define BATCH     16 /* Number of keys prefetched ahead by the batch functions */
+#define PARALLEL (1 << 16) /* Minimum number of buckets for a parallel rebuild */
+#define HTAB_HIST 16 /* Number of chain lengths in the histogram of htab_stats */
+
+typedef enum {
+  HTAB_KEY_STRING,             /* NUL-terminated string */
+  HTAB_KEY_SPAN,               /* hash_span, see hash.h */
+  HTAB_KEY_INT32,              /* int32_t */
+  HTAB_KEY_INT64               /* int64_t */
+} htab_key_type;
 
 typedef struct htab_entry {
   void *value;                 /* Pointer to the data */
   void *key;                   /* Hashkey */
   struct htab_entry **fstbuck; /* Pointer to the first slot */
   struct htab_entry *nexth;    /* Pointer to next htab_entry */
+  long hash;                   /* Cached result of the hash function */
 } htab_entry;
 
 typedef struct htab {
   htab_entry **buckets;  /* Array of pointers to htab_entrys */
+  htab_entry **oldbuckets; /* Buckets still being migrated, NULL if no rebuild is in progress */
   uint32_t num;          /* Number of entries */
   uint32_t maxent;       /* Maximum number of htab_entrys before rebuild */
   uint32_t htsize;       /* Size of the table */
   uint32_t mask;         /* Ensure a key is smaller than the number of buckets */
+  uint32_t minsize;      /* The table isn't shrunk below this size */
+  uint32_t oldsize;      /* Size of the old table */
+  uint32_t oldmask;      /* Mask of the old table */
+  uint32_t migrated;     /* Number of old buckets already migrated */
+  uint32_t iterators;    /* Number of iterators, migration is paused while > 0 */
+  uint32_t threads;      /* Number of threads used to rebuild a large table */
+  uint64_t hash_saved;   /* Calls to hashfunc avoided by the cached hash, only counted with HTAB_STATS */
+  uint64_t eq_saved;     /* Calls to eqfunc avoided by comparing the hash first, only counted with HTAB_STATS */
+  uint32_t rebuilds;     /* Number of rebuilds started */
+  uint64_t rebuild_ns;   /* Time spent rebuilding and migrating, single steps only timed with HTAB_STATS */
+  uint64_t gets;         /* Lookups, only counted with HTAB_STATS */
+  uint64_t hits;         /* Successful lookups, only counted with HTAB_STATS */
+  uint64_t eq_calls;     /* Calls to eqfunc, only counted with HTAB_STATS */
   bool (*eqfunc)();      /* Comperator function to find the matching entry */
   long (*hashfunc)();    /* Hash function to calculate the key */
+  long (*seeded_hashfunc)(void *key, uint64_t seed); /* Used instead of hashfunc if set */
+  uint64_t seed;         /* Seed for seeded_hashfunc */
+  bloom *filter;         /* Filter of the hashes of all keys, NULL if disabled */
+  bloom *oldfilter;      /* Filter of the keys in oldbuckets during a migration */
+  uint32_t filter_bits;  /* Bits per key of the filter */
+  uint32_t filter_stale; /* Deleted keys which are still in the filter */
+  uint64_t filtered;     /* Lookups answered by the filter, only counted with HTAB_STATS */
 } htab;
 
+typedef struct {
+   uint32_t num;               /* Number of entries */
+   uint32_t htsize;            /* Number of buckets */
+   double load_factor;         /* Entries per bucket */
+   uint32_t rebuilds;          /* Number of rebuilds started */
+   uint64_t rebuild_ns;        /* Time spent rebuilding and migrating, single steps only timed with HTAB_STATS */
+   bool rebuilding;            /* A migration is in progress */
+   uint64_t bucket_bytes;      /* Memory used by the bucket arrays */
+   uint64_t entry_bytes;       /* Memory used by the entries */
+   uint64_t hash_saved;        /* Calls to hashfunc avoided, only counted with HTAB_STATS */
+   uint64_t eq_saved;          /* Calls to eqfunc avoided, only counted with HTAB_STATS */
+   uint64_t gets;              /* Lookups, only counted with HTAB_STATS */
+   uint64_t hits;              /* Successful lookups, only counted with HTAB_STATS */
+   uint64_t eq_calls;          /* Calls to eqfunc, only counted with HTAB_STATS */
+   uint64_t filtered;          /* Lookups answered by the filter, only counted with HTAB_STATS */
+   uint64_t filter_bytes;      /* Memory used by the filters */
+   /* Only filled in by a scan */
+   uint32_t chains[HTAB_HIST]; /* Number of chains per length, the last one counts longer ones too */
+   uint32_t max_chain;         /* Length of the longest chain */
+   double empty_ratio;         /* Share of empty buckets */
+} htab_stats;
+
 typedef struct {
    htab *ht;
    htab_entry *next;
    htab_entry **bucket;
+   htab_entry **end;    /* End of the bucket array being iterated */
 } htab_it;
 
+/*
+ * Lookups (htab_get, htab_get_entry, htab_contains, htab_get_many) never 
+ * modify the table, so any number of threads may look up keys at the same 
+ * time as long as none modifies it. Built with -DHTAB_STATS, they update 
+ * the counters and are no longer safe to call concurrently.
+ *
+ * While an iterator is open, migration is paused and a rebuild which would
+ * have to finish a running migration is deferred until it is destroyed.
+ */
 
 htab *htab_create(void *fhash, void *fequals);
+htab *htab_create_sized(void *fhash, void *fequals, uint32_t n);
+htab *htab_create_with(htab_key_type type);
 void htab_destroy(htab *ht);
 void htab_destroy_free(htab *ht, void (*free)(htab_entry *entry));
 void *htab_get(htab* ht, void *key);
@@ -66,13 +136,25 @@ htab_entry *htab_get_entry(htab *ht, void *key);
 bool htab_contains(htab *ht, void *key);
 htab_entry *htab_put(htab* ht, void *key, void *value);
 htab_entry *htab_delete(htab *ht, void *key);
+void **htab_find_or_insert(htab *ht, void *key, bool *inserted);
+void *htab_update(htab *ht, void *key, void *(*update)(void *key, void *value, void *arg), void *arg);
+void htab_get_many(htab *ht, void **keys, void **values, uint32_t n);
+uint32_t htab_put_many(htab *ht, void **keys, void **values, uint32_t n, htab_entry **replaced);
+uint32_t htab_delete_many(htab *ht, void **keys, uint32_t n, htab_entry **deleted);
 void htab_rehash(htab *ht);
+void htab_reserve(htab *ht, uint32_t n);
+void htab_shrink_to_fit(htab *ht);
+void htab_set_threads(htab *ht, uint32_t threads);
+void htab_set_filter(htab *ht, uint32_t bits_per_key);
+htab *htab_build_from_arrays(void *fhash, void *fequals, void **keys, void **values, 
+      uint32_t n, uint32_t nthreads);
 void htab_entry_destroy(htab_entry *entry);
 
 htab_it *htab_it_create(htab *ht);
 void htab_it_destroy(htab_it *it);
 bool htab_it_has_next(htab_it *it);
 htab_entry *htab_it_get_next(htab_it *it);
+void htab_get_stats(htab *ht, htab_stats *stats, bool scan);
 void htab_print_state(htab *ht);
 
 #endif //_HTAB_H_
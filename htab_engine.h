@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _HTAB_ENGINE_H_
+#define _HTAB_ENGINE_H_
+
+/*
+ * Selects the engine behind the htab interface at build time. Code which 
+ * includes this header instead of htab.h runs on the chained htab, or on 
+ * the open addressing oatab if compiled with -DHTAB_ENGINE_OATAB, without 
+ * any other change. Only the functions below and the key, value and num
+ * fields are common to both engines. The other htab functions, and the 
+ * modules built on htab (ftab, htab_map, cache), need the chained engine 
+ * and must not be used along with the switch.
+ */
+
+#ifdef HTAB_ENGINE_OATAB
+
+#include "oatab.h"
+
+#define HTAB_ENGINE           "oatab"
+
+#define htab                  oatab
+#define htab_entry            oatab_entry
+#define htab_it               oatab_it
+
+#define htab_create           oatab_create
+#define htab_create_with      oatab_create_with
+#define htab_destroy          oatab_destroy
+#define htab_destroy_free     oatab_destroy_free
+#define htab_get              oatab_get
+#define htab_get_entry        oatab_get_entry
+#define htab_contains         oatab_contains
+#define htab_put              oatab_put
+#define htab_delete           oatab_delete
+#define htab_rehash           oatab_rehash
+#define htab_entry_destroy    oatab_entry_destroy
+
+#define htab_it_create        oatab_it_create
+#define htab_it_destroy       oatab_it_destroy
+#define htab_it_has_next      oatab_it_has_next
+#define htab_it_get_next      oatab_it_get_next
+
+#else
+
+#include "htab.h"
+
+#define HTAB_ENGINE           "htab"
+
+#endif
+
+#endif //_HTAB_ENGINE_H_
@@ -0,0 +1,261 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _HTAB_GEN_H_
+#define _HTAB_GEN_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Generates a hashtable specialized for the given key and value types:
+ *
+ *    static inline uint64_t hash_long(long k) { return htab_gen_hash_int(k); }
+ *    static inline bool eq_long(long a, long b) { return a == b; }
+ *    HTAB_DECLARE(lmap, long, void *, hash_long, eq_long)
+ *
+ * declares the type lmap with the functions lmap_create, lmap_destroy,
+ * lmap_get, lmap_contains, lmap_put, lmap_delete and an iterator. Keys and
+ * values are stored in the table itself and the hash and equality functions 
+ * are called directly, so the compiler can inline them. The table uses 
+ * linear probing. Pointers returned by lmap_get are only valid until the 
+ * next lmap_put.
+ */
+
+#define HTAB_GEN_HSIZE   16 /* Initial size for the hashtable */
+
+#define HTAB_GEN_EMPTY    0
+#define HTAB_GEN_FULL     1
+#define HTAB_GEN_DELETED  2
+
+/* Spreads the bits of an integer key */
+static inline uint64_t
+htab_gen_hash_int(uint64_t k) {
+   k ^= k >> 33;
+   k *= 0xff51afd7ed558ccdULL;
+   k ^= k >> 33;
+   return k;
+}
+
+#define HTAB_DECLARE(name, key_t, val_t, hash, eq)                            \
+                                                                              \
+typedef struct {                                                              \
+   key_t key;                                                                 \
+   val_t value;                                                               \
+} name##_entry;                                                               \
+                                                                              \
+typedef struct {                                                              \
+   uint8_t *flags;              /* State of every slot */                     \
+   name##_entry *slots;         /* Array of slots */                          \
+   uint32_t num;                /* Number of entries */                       \
+   uint32_t deleted;            /* Number of deleted slots */                 \
+   uint32_t maxent;             /* Maximum number of used slots */            \
+   uint32_t htsize;             /* Size of the table */                       \
+   uint32_t mask;               /* Ensure an index is within the table */     \
+} name;                                                                       \
+                                                                              \
+typedef struct {                                                              \
+   name *ht;                                                                  \
+   uint32_t pos;                                                              \
+} name##_it;                                                                  \
+                                                                              \
+static inline void                                                            \
+name##_alloc(name *ht, uint32_t size) {                                       \
+   ht->htsize = size;                                                         \
+   ht->mask = size - 1;                                                       \
+   ht->maxent = size - size / 4;                                              \
+   ht->deleted = 0;                                                           \
+   ht->flags = (uint8_t *)calloc(size, sizeof(uint8_t));                      \
+   ht->slots = (name##_entry *)calloc(size, sizeof(name##_entry));            \
+}                                                                             \
+                                                                              \
+static inline name *                                                          \
+name##_create(void) {                                                         \
+   name *ht = (name *)calloc(1, sizeof(name));                                \
+   name##_alloc(ht, HTAB_GEN_HSIZE);                                          \
+   return ht;                                                                 \
+}                                                                             \
+                                                                              \
+static inline void                                                            \
+name##_destroy(name *ht) {                                                    \
+   free(ht->flags);                                                           \
+   free(ht->slots);                                                           \
+   free(ht);                                                                  \
+}                                                                             \
+                                                                              \
+static inline int64_t                                                         \
+name##_find(name *ht, key_t key) {                                            \
+   uint32_t pos = (uint32_t)(hash(key)) & ht->mask;                           \
+   uint32_t n;                                                                \
+                                                                              \
+   for (n=0; n < ht->htsize; n++) {                                           \
+      if (ht->flags[pos] == HTAB_GEN_EMPTY) {                                 \
+         return -1;                                                           \
+      }                                                                       \
+      if (ht->flags[pos] == HTAB_GEN_FULL && eq(ht->slots[pos].key, key)) {   \
+         return pos;                                                          \
+      }                                                                       \
+      pos = (pos + 1) & ht->mask;                                             \
+   }                                                                          \
+                                                                              \
+   return -1;                                                                 \
+}                                                                             \
+                                                                              \
+static inline val_t *                                                         \
+name##_get(name *ht, key_t key) {                                             \
+   int64_t pos = name##_find(ht, key);                                        \
+   return pos < 0 ? NULL : &ht->slots[pos].value;                             \
+}                                                                             \
+                                                                              \
+static inline bool                                                            \
+name##_contains(name *ht, key_t key) {                                        \
+   return name##_find(ht, key) >= 0;                                          \
+}                                                                             \
+                                                                              \
+/* Inserts a key which is known not to be in the table */                     \
+static inline void                                                            \
+name##_insert(name *ht, key_t key, val_t value) {                             \
+   uint32_t pos = (uint32_t)(hash(key)) & ht->mask;                           \
+                                                                              \
+   while (ht->flags[pos] == HTAB_GEN_FULL) {                                  \
+      pos = (pos + 1) & ht->mask;                                             \
+   }                                                                          \
+                                                                              \
+   if (ht->flags[pos] == HTAB_GEN_DELETED) {                                  \
+      ht->deleted--;                                                          \
+   }                                                                          \
+                                                                              \
+   ht->flags[pos] = HTAB_GEN_FULL;                                            \
+   ht->slots[pos].key = key;                                                  \
+   ht->slots[pos].value = value;                                              \
+   ht->num++;                                                                 \
+}                                                                             \
+                                                                              \
+static inline void                                                            \
+name##_rebuild(name *ht, uint32_t size) {                                     \
+   uint8_t *oldflags = ht->flags;                                             \
+   name##_entry *oldslots = ht->slots;                                        \
+   uint32_t oldsize = ht->htsize;                                             \
+   uint32_t i;                                                                \
+                                                                              \
+   name##_alloc(ht, size);                                                    \
+   ht->num = 0;                                                               \
+                                                                              \
+   for (i=0; i < oldsize; i++) {                                              \
+      if (oldflags[i] == HTAB_GEN_FULL) {                                     \
+         name##_insert(ht, oldslots[i].key, oldslots[i].value);               \
+      }                                                                       \
+   }                                                                          \
+                                                                              \
+   free(oldflags);                                                            \
+   free(oldslots);                                                            \
+}                                                                             \
+                                                                              \
+/* Returns true if an existing value was replaced, its previous value is      \
+ * stored in old if old is not NULL */                                        \
+static inline bool                                                            \
+name##_put(name *ht, key_t key, val_t value, val_t *old) {                    \
+   int64_t pos = name##_find(ht, key);                                        \
+                                                                              \
+   if (pos >= 0) {                                                            \
+      if (old) {                                                              \
+         *old = ht->slots[pos].value;                                         \
+      }                                                                       \
+      ht->slots[pos].value = value;                                           \
+      return true;                                                            \
+   }                                                                          \
+                                                                              \
+   if (ht->num + ht->deleted + 1 >= ht->maxent) {                             \
+      name##_rebuild(ht, ht->num < ht->maxent / 2 ?                           \
+                     ht->htsize : ht->htsize * 2);                            \
+   }                                                                          \
+                                                                              \
+   name##_insert(ht, key, value);                                             \
+   return false;                                                              \
+}                                                                             \
+                                                                              \
+/* Returns true if the key was found, its value is stored in old if old is    \
+ * not NULL */                                                                \
+static inline bool                                                            \
+name##_delete(name *ht, key_t key, val_t *old) {                              \
+   int64_t pos = name##_find(ht, key);                                        \
+                                                                              \
+   if (pos < 0) {                                                             \
+      return false;                                                           \
+   }                                                                          \
+                                                                              \
+   if (old) {                                                                 \
+      *old = ht->slots[pos].value;                                            \
+   }                                                                          \
+                                                                              \
+   ht->flags[pos] = HTAB_GEN_DELETED;                                         \
+   ht->deleted++;                                                             \
+   ht->num--;                                                                 \
+   return true;                                                               \
+}                                                                             \
+                                                                              \
+static inline uint32_t                                                        \
+name##_next_full(name *ht, uint32_t pos) {                                    \
+   while (pos < ht->htsize && ht->flags[pos] != HTAB_GEN_FULL) {              \
+      pos++;                                                                  \
+   }                                                                          \
+   return pos;                                                                \
+}                                                                             \
+                                                                              \
+static inline name##_it *                                                     \
+name##_it_create(name *ht) {                                                  \
+   name##_it *it = (name##_it *)calloc(1, sizeof(name##_it));                 \
+   it->ht = ht;                                                               \
+   it->pos = name##_next_full(ht, 0);                                         \
+   return it;                                                                 \
+}                                                                             \
+                                                                              \
+static inline void                                                            \
+name##_it_destroy(name##_it *it) {                                            \
+   free(it);                                                                  \
+}                                                                             \
+                                                                              \
+static inline bool                                                            \
+name##_it_has_next(name##_it *it) {                                           \
+   return it->pos < it->ht->htsize;                                           \
+}                                                                             \
+                                                                              \
+static inline name##_entry *                                                  \
+name##_it_get_next(name##_it *it) {                                           \
+   name##_entry *e;                                                           \
+                                                                              \
+   if (!name##_it_has_next(it)) {                                             \
+      return NULL;                                                            \
+   }                                                                          \
+                                                                              \
+   e = &it->ht->slots[it->pos];                                               \
+   it->pos = name##_next_full(it->ht, it->pos + 1);                           \
+   return e;                                                                  \
+}
+
+#endif //_HTAB_GEN_H_
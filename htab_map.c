@@ -0,0 +1,381 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <libgen.h>
+
+#include "htab_map.h"
+
+#define ALIGN8(n) (((n) + 7) & ~(uint64_t)7)
+
+/* A NULL string is written with length 0 */
+static hash_span
+string_bytes(void *data) {
+   hash_span span = { data, data ? strlen((const char *)data) + 1 : 0 };
+   return span;
+}
+
+static bool
+write_padded(FILE *f, const void *data, size_t len) {
+   static const char zero[8];
+
+   if (len && fwrite(data, 1, len, f) != len) {
+      return false;
+   }
+
+   return fwrite(zero, 1, ALIGN8(len) - len, f) == ALIGN8(len) - len;
+}
+
+/* Flushes the directory entry of path to disk, errors are ignored */
+static void
+sync_dir(const char *path) {
+   char *copy = strdup(path);
+   int fd = open(dirname(copy), O_RDONLY | O_DIRECTORY);
+
+   if (fd >= 0) {
+      fsync(fd);
+      close(fd);
+   }
+
+   free(copy);
+}
+
+/* Writes the snapshot to a unique temporary file in the directory of path,
+ * which is synced and renamed to path, so processes mapping an older 
+ * snapshot are not affected and a crash leaves either snapshot intact. 
+ * Fails if a key or value is longer than UINT32_MAX bytes. */
+bool
+htab_save(htab *ht, const char *path, htab_map_bytes key_bytes, htab_map_bytes value_bytes) {
+   htab_map_header hdr;
+   htab_map_entry *entries;
+   hash_span *keys, *values;
+   uint32_t *index, *fill;
+   uint32_t i, num = ht->num, htsize = 1;
+   uint64_t off;
+   char *tmp;
+   FILE *f;
+   bool ok = true;
+   htab_it *it;
+   int fd;
+
+   if (!key_bytes) {
+      key_bytes = string_bytes;
+   }
+
+   if (!value_bytes) {
+      value_bytes = string_bytes;
+   }
+
+   while (htsize < num) {
+      htsize <<= 1;
+   }
+
+   memset(&hdr, 0, sizeof(hdr));
+   memcpy(hdr.magic, HTAB_MAP_MAGIC, sizeof(hdr.magic));
+   hdr.seed = hash_seed();
+   hdr.num = num;
+   hdr.htsize = htsize;
+   hdr.index_off = ALIGN8(sizeof(hdr));
+   hdr.entries_off = hdr.index_off + ALIGN8((uint64_t)(htsize + 1) * sizeof(uint32_t));
+
+   entries = (htab_map_entry *)calloc(num ? num : 1, sizeof(htab_map_entry));
+   keys = (hash_span *)calloc(num ? num : 1, sizeof(hash_span));
+   values = (hash_span *)calloc(num ? num : 1, sizeof(hash_span));
+   index = (uint32_t *)calloc(htsize + 1, sizeof(uint32_t));
+   fill = (uint32_t *)calloc(htsize, sizeof(uint32_t));
+
+   /* Hash all keys and count the entries per bucket */
+   it = htab_it_create(ht);
+   for (i=0; htab_it_has_next(it); i++) {
+      htab_entry *e = htab_it_get_next(it);
+      keys[i] = key_bytes(e->key);
+      values[i] = value_bytes(e->value);
+
+      if (keys[i].len > UINT32_MAX || values[i].len > UINT32_MAX) {
+         ok = false;
+      }
+
+      entries[i].hash = hash_bytes(keys[i].data, keys[i].len, hdr.seed);
+      index[(entries[i].hash & (htsize - 1)) + 1]++;
+   }
+   htab_it_destroy(it);
+
+   for (i=0; i < htsize; i++) {
+      index[i+1] += index[i];
+      fill[i] = index[i];
+   }
+
+   /* Sort the entries by bucket and lay out the arena in that order */
+   {
+      htab_map_entry *sorted = (htab_map_entry *)calloc(num ? num : 1, sizeof(htab_map_entry));
+      hash_span *skeys = (hash_span *)calloc(num ? num : 1, sizeof(hash_span));
+      hash_span *svalues = (hash_span *)calloc(num ? num : 1, sizeof(hash_span));
+
+      for (i=0; i < num; i++) {
+         uint32_t pos = fill[entries[i].hash & (htsize - 1)]++;
+         sorted[pos].hash = entries[i].hash;
+         skeys[pos] = keys[i];
+         svalues[pos] = values[i];
+      }
+
+      free(entries);
+      free(keys);
+      free(values);
+      entries = sorted;
+      keys = skeys;
+      values = svalues;
+   }
+
+   off = hdr.entries_off + (uint64_t)num * sizeof(htab_map_entry);
+
+   for (i=0; i < num; i++) {
+      entries[i].key_off = off;
+      entries[i].key_len = keys[i].len;
+      off += ALIGN8(keys[i].len);
+      entries[i].value_off = off;
+      entries[i].value_len = values[i].len;
+      off += ALIGN8(values[i].len);
+   }
+
+   hdr.size = off;
+
+   tmp = (char *)malloc(strlen(path) + 8);
+   sprintf(tmp, "%s.XXXXXX", path);
+
+   if (!ok || (fd = mkstemp(tmp)) < 0) {
+      ok = false;
+   } else if ((f = fdopen(fd, "wb")) == NULL) {
+      ok = false;
+      close(fd);
+      unlink(tmp);
+   } else {
+      fchmod(fd, 0644);
+
+      ok = write_padded(f, &hdr, sizeof(hdr)) &&
+           write_padded(f, index, (htsize + 1) * sizeof(uint32_t)) &&
+           write_padded(f, entries, num * sizeof(htab_map_entry));
+
+      for (i=0; ok && i < num; i++) {
+         ok = write_padded(f, keys[i].data, keys[i].len) &&
+              write_padded(f, values[i].data, values[i].len);
+      }
+
+      if (ok) {
+         ok = fflush(f) == 0 && fsync(fd) == 0;
+      }
+
+      if (fclose(f) != 0) {
+         ok = false;
+      }
+
+      if (ok) {
+         ok = rename(tmp, path) == 0;
+      }
+
+      if (ok) {
+         sync_dir(path);
+      }
+
+      if (!ok) {
+         unlink(tmp);
+      }
+   }
+
+   free(tmp);
+   free(entries);
+   free(keys);
+   free(values);
+   free(index);
+   free(fill);
+
+   return ok;
+}
+
+/* Returns true if the range [off, off+len) lies within size bytes */
+static inline bool
+in_file(uint64_t off, uint64_t len, uint64_t size) {
+   return off <= size && len <= size - off;
+}
+
+/* Checks every offset of the snapshot before it's used, so a truncated or 
+ * corrupt file is rejected instead of being read out of bounds */
+static bool
+valid_snapshot(const uint8_t *base, const htab_map_header *hdr, uint64_t size) {
+   const uint32_t *index;
+   const htab_map_entry *entries;
+   uint32_t i;
+
+   if (memcmp(hdr->magic, HTAB_MAP_MAGIC, sizeof(hdr->magic)) != 0 || 
+         hdr->size != size || hdr->htsize == 0 ||
+         (hdr->htsize & (hdr->htsize - 1)) != 0 ||
+         hdr->index_off % 8 != 0 || hdr->entries_off % 8 != 0 ||
+         !in_file(hdr->index_off, ((uint64_t)hdr->htsize + 1) * sizeof(uint32_t), size) ||
+         !in_file(hdr->entries_off, (uint64_t)hdr->num * sizeof(htab_map_entry), size)) {
+      return false;
+   }
+
+   index = (const uint32_t *)(base + hdr->index_off);
+   entries = (const htab_map_entry *)(base + hdr->entries_off);
+
+   if (index[0] != 0 || index[hdr->htsize] != hdr->num) {
+      return false;
+   }
+
+   for (i=0; i < hdr->htsize; i++) {
+      if (index[i] > index[i+1]) {
+         return false;
+      }
+   }
+
+   for (i=0; i < hdr->num; i++) {
+      if (!in_file(entries[i].key_off, entries[i].key_len, size) ||
+            !in_file(entries[i].value_off, entries[i].value_len, size)) {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+htab_map *
+htab_open_mapped(const char *path) {
+   const htab_map_header *hdr;
+   htab_map *m;
+   struct stat st;
+   void *base;
+   int fd;
+
+   if ((fd = open(path, O_RDONLY)) < 0) {
+      return NULL;
+   }
+
+   if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(htab_map_header)) {
+      close(fd);
+      return NULL;
+   }
+
+   base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+
+   if (base == MAP_FAILED) {
+      return NULL;
+   }
+
+   hdr = (const htab_map_header *)base;
+
+   if (!valid_snapshot(base, hdr, st.st_size)) {
+      munmap(base, st.st_size);
+      return NULL;
+   }
+
+   m = (htab_map *)calloc(1, sizeof(htab_map));
+   m->base = (const uint8_t *)base;
+   m->hdr = hdr;
+   m->index = (const uint32_t *)(m->base + hdr->index_off);
+   m->entries = (const htab_map_entry *)(m->base + hdr->entries_off);
+   m->mask = hdr->htsize - 1;
+
+   return m;
+}
+
+void
+htab_map_close(htab_map *m) {
+   munmap((void *)m->base, m->hdr->size);
+   free(m);
+}
+
+const void *
+htab_map_get(htab_map *m, const void *key, size_t len, uint32_t *value_len) {
+   uint64_t hash = hash_bytes(key, len, m->hdr->seed);
+   uint32_t b = hash & m->mask;
+   uint32_t i;
+
+   for (i=m->index[b]; i < m->index[b+1]; i++) {
+      const htab_map_entry *e = &m->entries[i];
+
+      if (e->hash == hash && e->key_len == len && 
+            memcmp(m->base + e->key_off, key, len) == 0) {
+         if (value_len) {
+            *value_len = e->value_len;
+         }
+         return m->base + e->value_off;
+      }
+   }
+
+   return NULL;
+}
+
+bool
+htab_map_contains(htab_map *m, const void *key, size_t len) {
+   if (htab_map_get(m, key, len, NULL) != NULL) {
+      return true;
+   }
+
+   return false;
+}
+
+inline const void *
+htab_map_key(htab_map *m, const htab_map_entry *e) {
+   return m->base + e->key_off;
+}
+
+inline const void *
+htab_map_value(htab_map *m, const htab_map_entry *e) {
+   return m->base + e->value_off;
+}
+
+htab_map_it *
+htab_map_it_create(htab_map *m) {
+   htab_map_it *it = (htab_map_it *)calloc(1, sizeof(htab_map_it));
+   it->m = m;
+   return it;
+}
+
+void
+htab_map_it_destroy(htab_map_it *it) {
+   free(it);
+}
+
+bool
+htab_map_it_has_next(htab_map_it *it) {
+   return it->m && it->pos < it->m->hdr->num;
+}
+
+const htab_map_entry *
+htab_map_it_get_next(htab_map_it *it) {
+   if (!htab_map_it_has_next(it)) {
+      return NULL;
+   }
+
+   return &it->m->entries[it->pos++];
+}
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _HTAB_MAP_H_
+#define _HTAB_MAP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "hash.h"
+#include "htab.h"
+
+/*
+ * Snapshot of a htab in a file which can be mapped into memory and queried
+ * in place. The file consists of a header, an index with the first entry 
+ * of every bucket, the entries sorted by bucket, and an arena holding the 
+ * key and value bytes. All references are offsets from the start of the 
+ * file, so the file can be mapped at any address and shared between 
+ * processes. Keys are hashed with hash_bytes and the seed in the header.
+ */
+
+#define HTAB_MAP_MAGIC "HTABMAP1"
+
+typedef struct {
+   char magic[8];
+   uint64_t seed;              /* Seed for hash_bytes */
+   uint64_t size;              /* Size of the file */
+   uint32_t num;               /* Number of entries */
+   uint32_t htsize;            /* Number of buckets, a power of 2 */
+   uint64_t index_off;         /* Offset of htsize+1 uint32_t entry indexes */
+   uint64_t entries_off;       /* Offset of num htab_map_entrys */
+} htab_map_header;
+
+typedef struct {
+   uint64_t hash;              /* Full hash of the key */
+   uint64_t key_off;           /* Offset of the key bytes */
+   uint64_t value_off;         /* Offset of the value bytes */
+   uint32_t key_len;           /* Length of the key */
+   uint32_t value_len;         /* Length of the value */
+} htab_map_entry;
+
+typedef struct {
+   const uint8_t *base;        /* Start of the mapping */
+   const htab_map_header *hdr;
+   const uint32_t *index;
+   const htab_map_entry *entries;
+   uint32_t mask;
+} htab_map;
+
+typedef struct {
+   htab_map *m;
+   uint32_t pos;
+} htab_map_it;
+
+/* Serializes a key or value of the htab. If NULL is passed to htab_save,
+ * keys or values are taken to be NUL-terminated strings and are written 
+ * including the terminator, NULL is written with length 0. */
+typedef hash_span (*htab_map_bytes)(void *data);
+
+bool htab_save(htab *ht, const char *path, htab_map_bytes key_bytes, htab_map_bytes value_bytes);
+htab_map *htab_open_mapped(const char *path);
+void htab_map_close(htab_map *m);
+const void *htab_map_get(htab_map *m, const void *key, size_t len, uint32_t *value_len);
+bool htab_map_contains(htab_map *m, const void *key, size_t len);
+const void *htab_map_key(htab_map *m, const htab_map_entry *e);
+const void *htab_map_value(htab_map *m, const htab_map_entry *e);
+
+htab_map_it *htab_map_it_create(htab_map *m);
+void htab_map_it_destroy(htab_map_it *it);
+bool htab_map_it_has_next(htab_map_it *it);
+const htab_map_entry *htab_map_it_get_next(htab_map_it *it);
+
+#endif //_HTAB_MAP_H_
@@ -0,0 +1,233 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _ILIST_H_
+#define _ILIST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Intrusive list and stack. The caller embeds an ilist_link or istack_link
+ * in its own struct and gets the struct back from a link with 
+ * ILIST_CONTAINER_OF, so no operation allocates:
+ *
+ *    struct packet { int len; ilist_link link; };
+ *
+ *    ilist_link queue;
+ *    ilist_init(&queue);
+ *    ilist_append(&queue, &p->link);
+ *    p = ILIST_CONTAINER_OF(ilist_remove_first(&queue), struct packet, link);
+ *
+ * A list is circular like the Linux list_head, the head is a link which 
+ * isn't part of an object. Every link can be unlinked in O(1) without 
+ * knowing its list, which is why a list doesn't count its links.
+ */
+
+#define ILIST_CONTAINER_OF(ptr, type, member) \
+   ((type *)((char *)(ptr) - offsetof(type, member)))
+
+typedef struct ilist_link {
+   struct ilist_link *prev;
+   struct ilist_link *next;
+} ilist_link;
+
+/* Initializes a list head, or a link which isn't in a list */
+static inline void
+ilist_init(ilist_link *head) {
+   head->prev = head;
+   head->next = head;
+}
+
+static inline bool
+ilist_is_empty(ilist_link *head) {
+   return head->next == head;
+}
+
+static inline void
+ilist_link_between(ilist_link *e, ilist_link *prev, ilist_link *next) {
+   e->prev = prev;
+   e->next = next;
+   prev->next = e;
+   next->prev = e;
+}
+
+/* Adds e at the front of the list */
+static inline void
+ilist_insert(ilist_link *head, ilist_link *e) {
+   ilist_link_between(e, head, head->next);
+}
+
+/* Adds e at the end of the list */
+static inline void
+ilist_append(ilist_link *head, ilist_link *e) {
+   ilist_link_between(e, head->prev, head);
+}
+
+/* Removes e from its list, e is left as an empty list */
+static inline void
+ilist_unlink(ilist_link *e) {
+   e->prev->next = e->next;
+   e->next->prev = e->prev;
+   ilist_init(e);
+}
+
+static inline ilist_link *
+ilist_first(ilist_link *head) {
+   return ilist_is_empty(head) ? NULL : head->next;
+}
+
+static inline ilist_link *
+ilist_last(ilist_link *head) {
+   return ilist_is_empty(head) ? NULL : head->prev;
+}
+
+static inline ilist_link *
+ilist_remove_first(ilist_link *head) {
+   ilist_link *e = ilist_first(head);
+
+   if (e) {
+      ilist_unlink(e);
+   }
+
+   return e;
+}
+
+static inline ilist_link *
+ilist_remove_last(ilist_link *head) {
+   ilist_link *e = ilist_last(head);
+
+   if (e) {
+      ilist_unlink(e);
+   }
+
+   return e;
+}
+
+static inline void
+ilist_move_first(ilist_link *head, ilist_link *e) {
+   ilist_unlink(e);
+   ilist_insert(head, e);
+}
+
+/* Moves all links of src to the end of head, src is left empty */
+static inline void
+ilist_splice(ilist_link *head, ilist_link *src) {
+   if (ilist_is_empty(src)) {
+      return;
+   }
+
+   src->next->prev = head->prev;
+   head->prev->next = src->next;
+   src->prev->next = head;
+   head->prev = src->prev;
+   ilist_init(src);
+}
+
+/* Iterates the links of a list, pos must not be unlinked in the body */
+#define ILIST_FOREACH(pos, head) \
+   for (pos=(head)->next; pos != (head); pos=pos->next)
+
+#define ILIST_FOREACH_REVERSE(pos, head) \
+   for (pos=(head)->prev; pos != (head); pos=pos->prev)
+
+/* Iterates the links of a list, pos may be unlinked in the body */
+#define ILIST_FOREACH_SAFE(pos, tmp, head) \
+   for (pos=(head)->next, tmp=pos->next; pos != (head); pos=tmp, tmp=pos->next)
+
+/* Iterates the objects of a list, obj may be unlinked in the body */
+#define ILIST_FOREACH_ENTRY_SAFE(obj, tmp, head, member)                          \
+   for (obj=ILIST_CONTAINER_OF((head)->next, __typeof__(*obj), member),          \
+        tmp=ILIST_CONTAINER_OF(obj->member.next, __typeof__(*obj), member);      \
+        &obj->member != (head);                                                   \
+        obj=tmp, tmp=ILIST_CONTAINER_OF(tmp->member.next, __typeof__(*obj), member))
+
+#define ILIST_FOREACH_ENTRY(obj, head, member)                                    \
+   for (obj=ILIST_CONTAINER_OF((head)->next, __typeof__(*obj), member);          \
+        &obj->member != (head);                                                   \
+        obj=ILIST_CONTAINER_OF(obj->member.next, __typeof__(*obj), member))
+
+/* Intrusive stack, a singly linked list of istack_links */
+
+typedef struct istack_link {
+   struct istack_link *prev;
+} istack_link;
+
+typedef struct {
+   uint32_t size;
+   istack_link *top;
+} istack;
+
+static inline void
+istack_init(istack *s) {
+   s->size = 0;
+   s->top = NULL;
+}
+
+static inline bool
+istack_is_empty(istack *s) {
+   return s->size == 0;
+}
+
+static inline uint32_t
+istack_size(istack *s) {
+   return s->size;
+}
+
+static inline void
+istack_push(istack *s, istack_link *e) {
+   e->prev = s->top;
+   s->top = e;
+   s->size++;
+}
+
+static inline istack_link *
+istack_peek(istack *s) {
+   return s->top;
+}
+
+static inline istack_link *
+istack_pop(istack *s) {
+   istack_link *e = s->top;
+
+   if (e) {
+      s->top = e->prev;
+      s->size--;
+   }
+
+   return e;
+}
+
+/* Iterates from the top, pos may be popped in the body */
+#define ISTACK_FOREACH_SAFE(pos, tmp, s) \
+   for (pos=(s)->top, tmp=pos ? pos->prev : NULL; pos; pos=tmp, tmp=pos ? pos->prev : NULL)
+
+#define ISTACK_FOREACH(pos, s) \
+   for (pos=(s)->top; pos; pos=pos->prev)
+
+#endif //_ILIST_H_
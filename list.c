@@ -58,7 +58,7 @@ list_size(list *l) {
    return l->size;
 }
 
-void
+list_entry *
 list_insert(list *l, void *value) {
    list_entry *e = (list_entry *)calloc(1, sizeof(list_entry));
    e->value = value;
@@ -72,9 +72,11 @@ list_insert(list *l, void *value) {
 
    l->first = e;
    l->size++;
+
+   return e;
 }
 
-void
+list_entry *
 list_append(list *l, void *value) {
    list_entry *e = (list_entry *)calloc(1, sizeof(list_entry));
    e->value = value;
@@ -88,6 +90,8 @@ list_append(list *l, void *value) {
 
    l->last = e;
    l->size++;
+
+   return e;
 }
 
 void *
@@ -140,6 +144,50 @@ list_remove_last(list *l) {
    return value;
 }
 
+/* Removes an entry returned by list_insert or list_append in O(1) */
+void *
+list_remove_entry(list *l, list_entry *e) {
+   void *value;
+
+   if (e->prev) {
+      e->prev->next = e->next;
+   } else {
+      l->first = e->next;
+   }
+
+   if (e->next) {
+      e->next->prev = e->prev;
+   } else {
+      l->last = e->prev;
+   }
+
+   l->size--;
+   value = e->value;
+   free(e);
+
+   return value;
+}
+
+void
+list_move_first(list *l, list_entry *e) {
+   if (e == l->first) {
+      return;
+   }
+
+   e->prev->next = e->next;
+
+   if (e->next) {
+      e->next->prev = e->prev;
+   } else {
+      l->last = e->prev;
+   }
+
+   e->prev = NULL;
+   e->next = l->first;
+   l->first->prev = e;
+   l->first = e;
+}
+
 void
 list_apply(list *l, void (*f)(void *)) {
    list_it *it = list_it_create(l); 
@@ -53,10 +53,12 @@ list *list_create();
 void list_destroy(list *l);
 bool list_is_empty(list *l);
 uint32_t list_size(list *l);
-void list_insert(list *l, void *value);
-void list_append(list *l, void *value);
+list_entry *list_insert(list *l, void *value);
+list_entry *list_append(list *l, void *value);
 void *list_remove_first(list *l);
 void *list_remove_last(list *l);
+void *list_remove_entry(list *l, list_entry *e);
+void list_move_first(list *l, list_entry *e);
 void list_apply(list *l, void(*f)(void *));
 
 list_it *list_it_create(list *l);
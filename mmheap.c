@@ -0,0 +1,268 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "mmheap.h"
+
+#define PARENT(i)       (((i) - 1) / 2)
+#define GRANDPARENT(i)  (((i) - 3) / 4)
+
+static mmheap *
+mmheap_alloc(int (*cmp_func)(void *, void *), u_int32_t capacity) {
+   mmheap *h = (mmheap *)calloc(1, sizeof(mmheap));
+   h->cmp_func = cmp_func;
+   h->capacity = capacity > MMH_SIZE ? capacity : MMH_SIZE;
+   h->entries = (mmheap_entry **)calloc(h->capacity, sizeof(mmheap_entry *));
+   return h;
+}
+
+mmheap *
+mmheap_create(int (*cmp_func)(void *, void *)) {
+   return mmheap_alloc(cmp_func, MMH_SIZE);
+}
+
+void
+mmheap_destroy(mmheap *h) {
+   u_int32_t i;
+
+   for (i=0; i < h->size; i++) {
+      free(h->entries[i]);
+   }
+
+   free(h->entries);
+   free(h);
+}
+
+inline bool
+mmheap_is_empty(mmheap *h) {
+   return h->size == 0;
+}
+
+inline u_int32_t
+mmheap_size(mmheap *h) {
+   return h->size;
+}
+
+/* The root is on level 0, which is a min level */
+static inline bool
+is_min_level(u_int32_t i) {
+   return ((31 - __builtin_clz(i + 1)) & 1) == 0;
+}
+
+/* Compares the values at i and j, the result is negated on max levels so
+ * the same code serves both kinds of levels */
+static inline int
+cmp_at(mmheap *h, u_int32_t i, u_int32_t j, bool min) {
+   int c = h->cmp_func(h->entries[i]->value, h->entries[j]->value);
+   return min ? c : -c;
+}
+
+static inline void
+swap(mmheap *h, u_int32_t i, u_int32_t j) {
+   mmheap_entry *tmp = h->entries[i];
+
+   h->entries[i] = h->entries[j];
+   h->entries[j] = tmp;
+   h->entries[i]->pos = i;
+   h->entries[j]->pos = j;
+}
+
+static void
+bubble_up_grandparents(mmheap *h, u_int32_t i, bool min) {
+   while (i > 2 && cmp_at(h, i, GRANDPARENT(i), min) < 0) {
+      swap(h, i, GRANDPARENT(i));
+      i = GRANDPARENT(i);
+   }
+}
+
+static void
+bubble_up(mmheap *h, u_int32_t i) {
+   bool min = is_min_level(i);
+
+   if (i == 0) {
+      return;
+   }
+
+   /* A value on the wrong kind of level moves to the parent first */
+   if (cmp_at(h, i, PARENT(i), min) > 0) {
+      swap(h, i, PARENT(i));
+      bubble_up_grandparents(h, PARENT(i), !min);
+   } else {
+      bubble_up_grandparents(h, i, min);
+   }
+}
+
+static void
+trickle_down(mmheap *h, u_int32_t i) {
+   bool min = is_min_level(i);
+   u_int32_t m, j, last;
+
+   while (2 * i + 1 < h->size) {
+      /* Find the smallest (greatest on a max level) of the children and 
+       * grandchildren */
+      m = 2 * i + 1;
+      if (m + 1 < h->size && cmp_at(h, m + 1, m, min) < 0) {
+         m = m + 1;
+      }
+
+      last = 4 * i + 6 < h->size ? 4 * i + 6 : h->size - 1;
+      for (j=4 * i + 3; j <= last; j++) {
+         if (cmp_at(h, j, m, min) < 0) {
+            m = j;
+         }
+      }
+
+      if (cmp_at(h, m, i, min) >= 0) {
+         break;
+      }
+
+      swap(h, m, i);
+
+      if (m <= 2 * i + 2) {
+         break;
+      }
+
+      /* The value which came down from i may belong to the level above */
+      if (cmp_at(h, m, PARENT(m), min) > 0) {
+         swap(h, m, PARENT(m));
+      }
+
+      i = m;
+   }
+}
+
+static void
+mmheap_grow(mmheap *h) {
+   if (h->size == h->capacity) {
+      h->capacity *= 2;
+      h->entries = (mmheap_entry **)realloc(h->entries, h->capacity * sizeof(mmheap_entry *));
+   }
+}
+
+/* Builds a heap of n values in O(n) */
+mmheap *
+mmheap_heapify(int (*cmp_func)(void *, void *), void **values, u_int32_t n) {
+   mmheap *h = mmheap_alloc(cmp_func, n);
+   u_int32_t i;
+
+   for (i=0; i < n; i++) {
+      h->entries[i] = (mmheap_entry *)calloc(1, sizeof(mmheap_entry));
+      h->entries[i]->value = values[i];
+      h->entries[i]->pos = i;
+   }
+   h->size = n;
+
+   for (i=n / 2; i-- > 0; ) {
+      trickle_down(h, i);
+   }
+
+   return h;
+}
+
+/* Returns the entry of the value, which stays valid until the value is 
+ * removed */
+mmheap_entry *
+mmheap_push(mmheap *h, void *value) {
+   mmheap_entry *e = (mmheap_entry *)calloc(1, sizeof(mmheap_entry));
+
+   mmheap_grow(h);
+
+   e->value = value;
+   e->pos = h->size;
+   h->entries[h->size++] = e;
+   bubble_up(h, e->pos);
+
+   return e;
+}
+
+static inline u_int32_t
+max_pos(mmheap *h) {
+   if (h->size < 3) {
+      return h->size - 1;
+   }
+
+   return h->cmp_func(h->entries[1]->value, h->entries[2]->value) >= 0 ? 1 : 2;
+}
+
+void *
+mmheap_peek_min(mmheap *h) {
+   return mmheap_is_empty(h) ? NULL : h->entries[0]->value;
+}
+
+void *
+mmheap_peek_max(mmheap *h) {
+   return mmheap_is_empty(h) ? NULL : h->entries[max_pos(h)]->value;
+}
+
+void *
+mmheap_pop_min(mmheap *h) {
+   if (mmheap_is_empty(h)) {
+      return NULL;
+   }
+
+   return mmheap_remove(h, h->entries[0]);
+}
+
+void *
+mmheap_pop_max(mmheap *h) {
+   if (mmheap_is_empty(h)) {
+      return NULL;
+   }
+
+   return mmheap_remove(h, h->entries[max_pos(h)]);
+}
+
+/* Removes the entry returned by mmheap_push */
+void *
+mmheap_remove(mmheap *h, mmheap_entry *e) {
+   u_int32_t i = e->pos;
+   void *value = e->value;
+
+   /* Fill the hole with the last entry and restore the order around it */
+   if (i != --h->size) {
+      h->entries[i] = h->entries[h->size];
+      h->entries[i]->pos = i;
+      mmheap_update_key(h, h->entries[i]);
+   }
+
+   free(e);
+
+   return value;
+}
+
+/* Moves the entry to its place after the key of its value has changed */
+void
+mmheap_update_key(mmheap *h, mmheap_entry *e) {
+   u_int32_t i = e->pos;
+
+   /* Whatever ends up at i after moving up satisfies the ancestors, but 
+    * may still be out of order with the entries below i */
+   bubble_up(h, i);
+   trickle_down(h, i);
+}
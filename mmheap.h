@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _MMHEAP_H_
+#define _MMHEAP_H_
+
+#include <sys/types.h>
+#include <stdbool.h>
+
+/*
+ * Min-max heap, a double ended priority queue in an array. The levels of 
+ * the heap alternate between min levels, whose entries are smaller than 
+ * all entries below them, and max levels, whose entries are greater. The 
+ * smallest value is at the root and the greatest is one of its children. 
+ * The values are ordered by the same cmp_func as an olist. An entry keeps 
+ * its position in the array, so it can be used as a handle to remove a 
+ * value or to restore the heap after its key has changed.
+ */
+
+#define MMH_SIZE     16 /* Initial size of the array */
+
+typedef struct mmheap_entry {
+   void *value;
+   u_int32_t pos;                    /* Index of the entry in the array */
+} mmheap_entry;
+
+typedef struct {
+   u_int32_t size;
+   u_int32_t capacity;               /* Size of the array */
+   mmheap_entry **entries;
+   int (*cmp_func)(void *, void *);
+} mmheap;
+
+mmheap *mmheap_create(int (*cmp_func)(void *, void *));
+mmheap *mmheap_heapify(int (*cmp_func)(void *, void *), void **values, u_int32_t n);
+void mmheap_destroy(mmheap *h);
+bool mmheap_is_empty(mmheap *h);
+u_int32_t mmheap_size(mmheap *h);
+mmheap_entry *mmheap_push(mmheap *h, void *value);
+void *mmheap_peek_min(mmheap *h);
+void *mmheap_peek_max(mmheap *h);
+void *mmheap_pop_min(mmheap *h);
+void *mmheap_pop_max(mmheap *h);
+void *mmheap_remove(mmheap *h, mmheap_entry *e);
+void mmheap_update_key(mmheap *h, mmheap_entry *e);
+
+#endif //_MMHEAP_H_
@@ -0,0 +1,398 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "hash.h"
+#include "oatab.h"
+
+#define CTRL_EMPTY   0x80 /* Slot has never been used */
+#define CTRL_DELETED 0xfe /* Slot contained an entry which has been deleted */
+
+#if defined(__SSE2__)
+
+static inline uint32_t
+group_match(const uint8_t *group, uint8_t h2) {
+   __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+   return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2)));
+}
+
+static inline uint32_t
+group_match_empty(const uint8_t *group) {
+   return group_match(group, CTRL_EMPTY);
+}
+
+static inline uint32_t
+group_match_free(const uint8_t *group) {
+   /* Empty and deleted slots are the only ones with the high bit set */
+   return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+}
+
+#else
+
+static inline uint32_t
+group_match(const uint8_t *group, uint8_t h2) {
+   uint32_t i, mask = 0;
+
+   for (i=0; i < OA_GROUP; i++) {
+      if (group[i] == h2) {
+         mask |= 1U << i;
+      }
+   }
+
+   return mask;
+}
+
+static inline uint32_t
+group_match_empty(const uint8_t *group) {
+   return group_match(group, CTRL_EMPTY);
+}
+
+static inline uint32_t
+group_match_free(const uint8_t *group) {
+   uint32_t i, mask = 0;
+
+   for (i=0; i < OA_GROUP; i++) {
+      if (group[i] & 0x80) {
+         mask |= 1U << i;
+      }
+   }
+
+   return mask;
+}
+
+#endif
+
+/* Entries carry 7 bits of their hash in the control byte, so a weak user 
+ * supplied hash function is mixed first to spread its bits */
+static inline uint64_t
+oatab_hash(oatab *ht, void *key) {
+   if (ht->seeded_hashfunc) {
+      return (uint64_t)ht->seeded_hashfunc(key, ht->seed);
+   }
+
+   return hash_u64((uint64_t)ht->hashfunc(key), 0);
+}
+
+static void
+alloc_slots(oatab *ht, uint32_t size) {
+   ht->htsize = size;
+   ht->gmask = size / OA_GROUP - 1;
+   ht->maxent = size - size / 8;
+   ht->deleted = 0;
+   ht->ctrl = (uint8_t *)malloc(size);
+   memset(ht->ctrl, CTRL_EMPTY, size);
+   ht->slots = (oatab_entry *)calloc(size, sizeof(oatab_entry));
+}
+
+oatab *
+oatab_create(void *fhash, void *fequals) {
+   oatab *ht = (oatab *)calloc(1, sizeof(oatab));
+   ht->num = 0;
+   ht->hashfunc = fhash;
+   ht->eqfunc = fequals;
+   alloc_slots(ht, OA_HSIZE);
+   return ht;
+}
+
+/* Creates a table using the built-in functions for the given key type and
+ * a random seed */
+oatab *
+oatab_create_with(htab_key_type type) {
+   oatab *ht;
+
+   switch (type) {
+      case HTAB_KEY_STRING:
+         ht = oatab_create(NULL, hash_equals_string);
+         ht->seeded_hashfunc = hash_key_string;
+         break;
+      case HTAB_KEY_SPAN:
+         ht = oatab_create(NULL, hash_equals_span);
+         ht->seeded_hashfunc = hash_key_span;
+         break;
+      case HTAB_KEY_INT32:
+         ht = oatab_create(NULL, hash_equals_int32);
+         ht->seeded_hashfunc = hash_key_int32;
+         break;
+      case HTAB_KEY_INT64:
+         ht = oatab_create(NULL, hash_equals_int64);
+         ht->seeded_hashfunc = hash_key_int64;
+         break;
+      default:
+         return NULL;
+   }
+
+   ht->seed = hash_seed();
+   return ht;
+}
+
+void
+oatab_destroy(oatab *ht) {
+   free(ht->ctrl);
+   free(ht->slots);
+   free(ht);
+}
+
+void
+oatab_destroy_free(oatab *ht, void (*free_entry)(oatab_entry *entry)) {
+   uint32_t i;
+
+   for (i=0; i < ht->htsize; i++) {
+      if (!(ht->ctrl[i] & 0x80)) {
+         free_entry(&ht->slots[i]);
+      }
+   }
+
+   oatab_destroy(ht);
+}
+
+static inline int32_t
+find_slot(oatab *ht, void *key, uint64_t h) {
+   uint8_t h2 = h & 0x7f;
+   uint32_t g = (h >> 7) & ht->gmask;
+   uint32_t step = 0;
+
+   for (;;) {
+      uint8_t *group = &ht->ctrl[g * OA_GROUP];
+      uint32_t match = group_match(group, h2);
+
+      while (match) {
+         uint32_t pos = g * OA_GROUP + __builtin_ctz(match);
+
+         if (ht->eqfunc(key, ht->slots[pos].key)) {
+            return pos;
+         }
+
+         match &= match - 1;
+      }
+
+      if (group_match_empty(group) || step > ht->gmask) {
+         return -1;
+      }
+
+      g = (g + ++step) & ht->gmask;
+   }
+}
+
+/* Returns the first free slot on the probe sequence of the given hash */
+static inline uint32_t
+find_free(oatab *ht, uint64_t h) {
+   uint32_t g = (h >> 7) & ht->gmask;
+   uint32_t step = 0;
+
+   for (;;) {
+      uint32_t match = group_match_free(&ht->ctrl[g * OA_GROUP]);
+
+      if (match) {
+         return g * OA_GROUP + __builtin_ctz(match);
+      }
+
+      g = (g + ++step) & ht->gmask;
+   }
+}
+
+oatab_entry *
+oatab_get_entry(oatab *ht, void *key) {
+   int32_t pos = find_slot(ht, key, oatab_hash(ht, key));
+
+   if (pos < 0) {
+      return NULL;
+   }
+
+   return &ht->slots[pos];
+}
+
+void *
+oatab_get(oatab *ht, void *key) {
+   oatab_entry *entry = oatab_get_entry(ht, key);
+
+   if (entry) {
+      return entry->value;
+   }
+
+   return NULL;
+}
+
+bool
+oatab_contains(oatab *ht, void *key) {
+   if (oatab_get(ht, key) != NULL) {
+      return true;
+   }
+
+   return false;
+}
+
+static void
+rebuild_ht(oatab *ht, uint32_t size) {
+   uint8_t *oldctrl = ht->ctrl;
+   oatab_entry *oldslots = ht->slots;
+   uint32_t oldsize = ht->htsize;
+   uint32_t i;
+
+   alloc_slots(ht, size);
+
+   /* Keys are known to be unique, so no comparison is necessary */
+   for (i=0; i < oldsize; i++) {
+      if (!(oldctrl[i] & 0x80)) {
+         uint64_t h = oatab_hash(ht, oldslots[i].key);
+         uint32_t pos = find_free(ht, h);
+         ht->ctrl[pos] = h & 0x7f;
+         ht->slots[pos] = oldslots[i];
+      }
+   }
+
+   free(oldctrl);
+   free(oldslots);
+}
+
+void
+oatab_rehash(oatab *ht) {
+   rebuild_ht(ht, ht->htsize);
+}
+
+oatab_entry *
+oatab_put(oatab *ht, void *key, void *value) {
+   uint64_t h;
+   int32_t pos;
+
+   if (ht->num + ht->deleted + 1 >= ht->maxent) {
+      /* Reclaim the tombstones if they make up a large part of the table */
+      if (ht->num < ht->maxent / 2) {
+         rebuild_ht(ht, ht->htsize);
+      } else {
+         rebuild_ht(ht, ht->htsize * OA_GROWTH);
+      }
+   }
+
+   h = oatab_hash(ht, key);
+   pos = find_slot(ht, key, h);
+
+   if (pos >= 0) {
+      oatab_entry *entry = (oatab_entry *)calloc(1, sizeof(oatab_entry));
+      *entry = ht->slots[pos];
+      ht->slots[pos].key = key;
+      ht->slots[pos].value = value;
+      return entry;
+   }
+
+   pos = find_free(ht, h);
+
+   if (ht->ctrl[pos] == CTRL_DELETED) {
+      ht->deleted--;
+   }
+
+   ht->ctrl[pos] = h & 0x7f;
+   ht->slots[pos].key = key;
+   ht->slots[pos].value = value;
+   ht->num++;
+
+   return NULL;
+}
+
+oatab_entry *
+oatab_delete(oatab *ht, void *key) {
+   int32_t pos = find_slot(ht, key, oatab_hash(ht, key));
+   oatab_entry *entry;
+
+   if (pos < 0) {
+      return NULL;
+   }
+
+   entry = (oatab_entry *)calloc(1, sizeof(oatab_entry));
+   *entry = ht->slots[pos];
+
+   /* A group which still has an empty slot never terminated a probe 
+    * sequence, so the slot can be reused without a tombstone */
+   if (group_match_empty(&ht->ctrl[pos & ~(OA_GROUP - 1)])) {
+      ht->ctrl[pos] = CTRL_EMPTY;
+   } else {
+      ht->ctrl[pos] = CTRL_DELETED;
+      ht->deleted++;
+   }
+
+   ht->slots[pos].key = NULL;
+   ht->slots[pos].value = NULL;
+   ht->num--;
+
+   return entry;
+}
+
+void
+oatab_entry_destroy(oatab_entry *entry) {
+   free(entry);
+}
+
+static inline uint32_t
+next_full(oatab *ht, uint32_t pos) {
+   while (pos < ht->htsize && (ht->ctrl[pos] & 0x80)) {
+      pos++;
+   }
+
+   return pos;
+}
+
+oatab_it *
+oatab_it_create(oatab *ht) {
+   oatab_it *it = (oatab_it *)calloc(1, sizeof(oatab_it));
+
+   if (ht) {
+      it->ht = ht;
+      it->pos = next_full(ht, 0);
+   }
+
+   return it;
+}
+
+void
+oatab_it_destroy(oatab_it *it) {
+   free(it);
+}
+
+bool
+oatab_it_has_next(oatab_it *it) {
+   return it->ht && it->pos < it->ht->htsize;
+}
+
+oatab_entry *
+oatab_it_get_next(oatab_it *it) {
+   oatab_entry *e;
+
+   if (!oatab_it_has_next(it)) {
+      return NULL;
+   }
+
+   e = &it->ht->slots[it->pos];
+   it->pos = next_full(it->ht, it->pos + 1);
+
+   return e;
+}
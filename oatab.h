@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _OATAB_H_
+#define _OATAB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "htab.h"
+
+/*
+ * Open addressing hashtable. The slots are stored in one flat array and a
+ * parallel array of control bytes holds 7 bits of the hash for every slot.
+ * Lookups compare a whole group of control bytes at once and only call the
+ * comparator for slots whose control byte matches. The interface mirrors
+ * the one of htab, see htab_engine.h to switch between the two.
+ */
+
+#define OA_GROUP    16 /* Number of slots per group */
+#define OA_HSIZE    16 /* Initial size for the hashtable */
+#define OA_GROWTH    2 /* Growth factor */
+
+typedef struct oatab_entry {
+   void *value;                /* Pointer to the data */
+   void *key;                  /* Hashkey */
+} oatab_entry;
+
+typedef struct oatab {
+   uint8_t *ctrl;              /* Control bytes, one per slot */
+   oatab_entry *slots;         /* Array of slots */
+   uint32_t num;               /* Number of entries */
+   uint32_t deleted;           /* Number of tombstones */
+   uint32_t maxent;            /* Maximum number of used slots before rebuild */
+   uint32_t htsize;            /* Number of slots */
+   uint32_t gmask;             /* Ensure a group index is within the table */
+   bool (*eqfunc)();           /* Comperator function to find the matching entry */
+   long (*hashfunc)();         /* Hash function to calculate the key */
+   long (*seeded_hashfunc)(void *key, uint64_t seed); /* Used instead of hashfunc if set */
+   uint64_t seed;              /* Seed for seeded_hashfunc */
+} oatab;
+
+typedef struct {
+   oatab *ht;
+   uint32_t pos;
+} oatab_it;
+
+oatab *oatab_create(void *fhash, void *fequals);
+oatab *oatab_create_with(htab_key_type type);
+void oatab_destroy(oatab *ht);
+void oatab_destroy_free(oatab *ht, void (*free)(oatab_entry *entry));
+void *oatab_get(oatab *ht, void *key);
+oatab_entry *oatab_get_entry(oatab *ht, void *key);
+bool oatab_contains(oatab *ht, void *key);
+oatab_entry *oatab_put(oatab *ht, void *key, void *value);
+oatab_entry *oatab_delete(oatab *ht, void *key);
+void oatab_rehash(oatab *ht);
+void oatab_entry_destroy(oatab_entry *entry);
+
+oatab_it *oatab_it_create(oatab *ht);
+void oatab_it_destroy(oatab_it *it);
+bool oatab_it_has_next(oatab_it *it);
+oatab_entry *oatab_it_get_next(oatab_it *it);
+
+#endif //_OATAB_H_
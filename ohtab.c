@@ -0,0 +1,335 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hash.h"
+#include "ohtab.h"
+
+static inline long
+ohtab_hash(ohtab *ht, void *key) {
+   if (ht->seeded_hashfunc) {
+      return ht->seeded_hashfunc(key, ht->seed);
+   }
+
+   /* Spread the bits of the user supplied hash */
+   return (long)hash_u64((uint64_t)ht->hashfunc(key), 0);
+}
+
+/* A key may be NULL, so holes are only told apart by the bitmap */
+static inline bool
+entry_live(ohtab *ht, uint32_t i) {
+   return ht->live[i >> 6] & (1ULL << (i & 63));
+}
+
+static inline uint64_t *
+alloc_live(uint32_t maxent) {
+   return (uint64_t *)calloc((maxent + 63) / 64, sizeof(uint64_t));
+}
+
+static void
+alloc_index(ohtab *ht, uint32_t size) {
+   ht->htsize = size;
+   ht->mask = size - 1;
+   ht->maxent = size * 2 / 3;
+   ht->deleted = 0;
+   ht->index = (int32_t *)malloc(size * sizeof(int32_t));
+   memset(ht->index, 0xff, size * sizeof(int32_t));
+}
+
+ohtab *
+ohtab_create(void *fhash, void *fequals) {
+   ohtab *ht = (ohtab *)calloc(1, sizeof(ohtab));
+   ht->hashfunc = fhash;
+   ht->eqfunc = fequals;
+   alloc_index(ht, OH_HSIZE);
+   ht->entries = (ohtab_entry *)calloc(ht->maxent, sizeof(ohtab_entry));
+   ht->live = alloc_live(ht->maxent);
+   return ht;
+}
+
+/* Creates a table using the built-in functions for the given key type and
+ * a random seed */
+ohtab *
+ohtab_create_with(htab_key_type type) {
+   ohtab *ht;
+
+   switch (type) {
+      case HTAB_KEY_STRING:
+         ht = ohtab_create(NULL, hash_equals_string);
+         ht->seeded_hashfunc = hash_key_string;
+         break;
+      case HTAB_KEY_SPAN:
+         ht = ohtab_create(NULL, hash_equals_span);
+         ht->seeded_hashfunc = hash_key_span;
+         break;
+      case HTAB_KEY_INT32:
+         ht = ohtab_create(NULL, hash_equals_int32);
+         ht->seeded_hashfunc = hash_key_int32;
+         break;
+      case HTAB_KEY_INT64:
+         ht = ohtab_create(NULL, hash_equals_int64);
+         ht->seeded_hashfunc = hash_key_int64;
+         break;
+      default:
+         return NULL;
+   }
+
+   ht->seed = hash_seed();
+   return ht;
+}
+
+void
+ohtab_destroy(ohtab *ht) {
+   free(ht->index);
+   free(ht->entries);
+   free(ht->live);
+   free(ht);
+}
+
+void
+ohtab_destroy_free(ohtab *ht, void (*free_entry)(ohtab_entry *entry)) {
+   uint32_t i;
+
+   for (i=0; i < ht->used; i++) {
+      if (entry_live(ht, i)) {
+         free_entry(&ht->entries[i]);
+      }
+   }
+
+   ohtab_destroy(ht);
+}
+
+/* Returns the index slot of the key or -1 */
+static inline int64_t
+find_slot(ohtab *ht, void *key, long hash) {
+   uint32_t pos = hash & ht->mask;
+   int32_t idx;
+
+   while ((idx = ht->index[pos]) != OH_EMPTY) {
+      if (idx >= 0 && ht->entries[idx].hash == hash && 
+            ht->eqfunc(key, ht->entries[idx].key)) {
+         return pos;
+      }
+      pos = (pos + 1) & ht->mask;
+   }
+
+   return -1;
+}
+
+ohtab_entry *
+ohtab_get_entry(ohtab *ht, void *key) {
+   int64_t pos = find_slot(ht, key, ohtab_hash(ht, key));
+
+   if (pos < 0) {
+      return NULL;
+   }
+
+   return &ht->entries[ht->index[pos]];
+}
+
+void *
+ohtab_get(ohtab *ht, void *key) {
+   ohtab_entry *entry = ohtab_get_entry(ht, key);
+
+   if (entry) {
+      return entry->value;
+   }
+
+   return NULL;
+}
+
+bool
+ohtab_contains(ohtab *ht, void *key) {
+   if (ohtab_get(ht, key) != NULL) {
+      return true;
+   }
+
+   return false;
+}
+
+/* Compacts the entry array, keeping the order, and rebuilds the index */
+static void
+rebuild_ht(ohtab *ht, uint32_t size) {
+   ohtab_entry *entries = (ohtab_entry *)calloc(size * 2 / 3, sizeof(ohtab_entry));
+   uint64_t *live = alloc_live(size * 2 / 3);
+   uint32_t i, n = 0;
+
+   for (i=0; i < ht->used; i++) {
+      if (entry_live(ht, i)) {
+         live[n >> 6] |= 1ULL << (n & 63);
+         entries[n++] = ht->entries[i];
+      }
+   }
+
+   free(ht->entries);
+   free(ht->live);
+   free(ht->index);
+   alloc_index(ht, size);
+   ht->entries = entries;
+   ht->live = live;
+   ht->used = n;
+
+   for (i=0; i < n; i++) {
+      uint32_t pos = entries[i].hash & ht->mask;
+
+      while (ht->index[pos] != OH_EMPTY) {
+         pos = (pos + 1) & ht->mask;
+      }
+
+      ht->index[pos] = i;
+   }
+}
+
+void
+ohtab_rehash(ohtab *ht) {
+   rebuild_ht(ht, ht->htsize);
+}
+
+ohtab_entry *
+ohtab_put(ohtab *ht, void *key, void *value) {
+   long hash = ohtab_hash(ht, key);
+   int64_t pos = find_slot(ht, key, hash);
+   ohtab_entry *e;
+
+   if (pos >= 0) {
+      ohtab_entry *entry = (ohtab_entry *)calloc(1, sizeof(ohtab_entry));
+      e = &ht->entries[ht->index[pos]];
+      *entry = *e;
+      e->key = key;
+      e->value = value;
+      return entry;
+   }
+
+   /* Tombstones in the index always leave a hole in entries, so the index
+    * can't fill up before the entry array */
+   if (ht->used >= ht->maxent) {
+      uint32_t size = OH_HSIZE;
+
+      /* Leave room for as many entries again as are in the table */
+      while (size * 2 / 3 <= ht->num * 2) {
+         size <<= 1;
+      }
+
+      rebuild_ht(ht, size);
+   }
+
+   pos = hash & ht->mask;
+
+   while (ht->index[pos] >= 0) {
+      pos = (pos + 1) & ht->mask;
+   }
+
+   if (ht->index[pos] == OH_DELETED) {
+      ht->deleted--;
+   }
+
+   e = &ht->entries[ht->used];
+   e->key = key;
+   e->value = value;
+   e->hash = hash;
+   ht->live[ht->used >> 6] |= 1ULL << (ht->used & 63);
+   ht->index[pos] = ht->used++;
+   ht->num++;
+
+   return NULL;
+}
+
+ohtab_entry *
+ohtab_delete(ohtab *ht, void *key) {
+   int64_t pos = find_slot(ht, key, ohtab_hash(ht, key));
+   ohtab_entry *entry, *e;
+
+   if (pos < 0) {
+      return NULL;
+   }
+
+   e = &ht->entries[ht->index[pos]];
+   entry = (ohtab_entry *)calloc(1, sizeof(ohtab_entry));
+   *entry = *e;
+   e->key = NULL;
+   e->value = NULL;
+   ht->live[ht->index[pos] >> 6] &= ~(1ULL << (ht->index[pos] & 63));
+
+   ht->index[pos] = OH_DELETED;
+   ht->deleted++;
+   ht->num--;
+
+   return entry;
+}
+
+void
+ohtab_entry_destroy(ohtab_entry *entry) {
+   free(entry);
+}
+
+static inline uint32_t
+next_used(ohtab *ht, uint32_t pos) {
+   while (pos < ht->used && !entry_live(ht, pos)) {
+      pos++;
+   }
+
+   return pos;
+}
+
+ohtab_it *
+ohtab_it_create(ohtab *ht) {
+   ohtab_it *it = (ohtab_it *)calloc(1, sizeof(ohtab_it));
+
+   if (ht) {
+      it->ht = ht;
+      it->pos = next_used(ht, 0);
+   }
+
+   return it;
+}
+
+void
+ohtab_it_destroy(ohtab_it *it) {
+   free(it);
+}
+
+bool
+ohtab_it_has_next(ohtab_it *it) {
+   return it->ht && it->pos < it->ht->used;
+}
+
+ohtab_entry *
+ohtab_it_get_next(ohtab_it *it) {
+   ohtab_entry *e;
+
+   if (!ohtab_it_has_next(it)) {
+      return NULL;
+   }
+
+   e = &it->ht->entries[it->pos];
+   it->pos = next_used(it->ht, it->pos + 1);
+
+   return e;
+}
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _OHTAB_H_
+#define _OHTAB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "htab.h"
+
+/*
+ * Insertion ordered hashtable. The entries are stored in a dense array in
+ * insertion order and the hashtable itself only holds indexes into that 
+ * array. Iteration walks the array, so it is deterministic and doesn't
+ * depend on the size of the table. Deleted entries leave a hole in the 
+ * array, marked in a bitmap, which is removed when the table is rebuilt.
+ * Keys may be NULL. Replacing the value of an existing key keeps its 
+ * position. Pointers to entries are only valid until the next 
+ * ohtab_put. ohtab_create_with uses the built-in functions of hash.h with a
+ * random seed, the hash of other functions is mixed with hash_u64.
+ */
+
+#define OH_HSIZE     16 /* Initial size of the index, a power of 2 */
+#define OH_EMPTY     -1 /* Index slot has never been used */
+#define OH_DELETED   -2 /* Index slot pointed to an entry which has been deleted */
+
+typedef struct ohtab_entry {
+   void *value;                /* Pointer to the data */
+   void *key;                  /* Hashkey */
+   long hash;                  /* Cached hash of the key, after mixing */
+} ohtab_entry;
+
+typedef struct ohtab {
+   int32_t *index;             /* Indexes into entries, or OH_EMPTY/OH_DELETED */
+   ohtab_entry *entries;       /* Entries in insertion order */
+   uint64_t *live;             /* One bit per slot in entries, set if it holds an entry */
+   uint32_t num;               /* Number of entries */
+   uint32_t used;              /* Number of used slots in entries, including holes */
+   uint32_t deleted;           /* Number of OH_DELETED slots in the index */
+   uint32_t maxent;            /* Size of the entry array, 2/3 of the index */
+   uint32_t htsize;            /* Size of the index */
+   uint32_t mask;              /* Ensure a key is smaller than the size of the index */
+   bool (*eqfunc)();           /* Comperator function to find the matching entry */
+   long (*hashfunc)();         /* Hash function to calculate the key */
+   long (*seeded_hashfunc)(void *key, uint64_t seed); /* Used instead of hashfunc if set */
+   uint64_t seed;              /* Seed for seeded_hashfunc */
+} ohtab;
+
+typedef struct {
+   ohtab *ht;
+   uint32_t pos;
+} ohtab_it;
+
+ohtab *ohtab_create(void *fhash, void *fequals);
+ohtab *ohtab_create_with(htab_key_type type);
+void ohtab_destroy(ohtab *ht);
+void ohtab_destroy_free(ohtab *ht, void (*free)(ohtab_entry *entry));
+void *ohtab_get(ohtab *ht, void *key);
+ohtab_entry *ohtab_get_entry(ohtab *ht, void *key);
+bool ohtab_contains(ohtab *ht, void *key);
+ohtab_entry *ohtab_put(ohtab *ht, void *key, void *value);
+ohtab_entry *ohtab_delete(ohtab *ht, void *key);
+void ohtab_rehash(ohtab *ht);
+void ohtab_entry_destroy(ohtab_entry *entry);
+
+ohtab_it *ohtab_it_create(ohtab *ht);
+void ohtab_it_destroy(ohtab_it *it);
+bool ohtab_it_has_next(ohtab_it *it);
+ohtab_entry *ohtab_it_get_next(ohtab_it *it);
+
+#endif //_OHTAB_H_
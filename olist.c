@@ -34,6 +34,8 @@ olist *
 olist_create(int (*cmp_func)(void *, void *)) {
    olist *l = (olist *)calloc(1, sizeof(olist));
    l->cmp_func = cmp_func;
+   l->level = 1;
+   l->rng = 0x9e3779b9;
    return l;
 }
 
@@ -60,45 +62,384 @@ olist_size(olist *l) {
    return l->size;
 }
 
-void
-olist_insert(olist *l, void *value) {
-   olist_entry *e = (olist_entry *)calloc(1, sizeof(olist_entry));
-   e->value = value;
-   
-   if (!olist_is_empty(l)) {
-      olist_entry *cur = l->first;
-
-      while (cur) {
-         if (l->cmp_func(value, cur->value) <= 0) {
-            e->next = cur; 
-            e->prev = cur->prev;
-            cur->prev = e;
-            if (e->prev) {
-               e->prev->next = e;
-            } else {
-               l->first = e;
-            }
+/* Returns the link to the next entry on the given level, of the list head
+ * if e is NULL */
+static inline olist_entry **
+olist_next(olist *l, olist_entry *e, u_int32_t level) {
+   if (e) {
+      return level ? &e->skip[level-1].next : &e->next;
+   }
+
+   return level ? &l->skip[level-1].next : &l->first;
+}
+
+/* Returns the span of a link on level 1 or above */
+static inline u_int32_t *
+olist_span(olist *l, olist_entry *e, u_int32_t level) {
+   return e ? &e->skip[level-1].span : &l->skip[level-1].span;
+}
+
+static u_int32_t
+random_height(olist *l) {
+   u_int32_t h = 1, r;
+
+   /* xorshift32 */
+   l->rng ^= l->rng << 13;
+   l->rng ^= l->rng >> 17;
+   l->rng ^= l->rng << 5;
+
+   for (r=l->rng; h < OL_LEVELS && r % OL_P == 0; r /= OL_P) {
+      h++;
+   }
+
+   return h;
+}
+
+/* Fills update with the last entry on every level whose value is smaller
+ * than value, or not greater if after_equal is set, or NULL for the list 
+ * head. The number of entries up to and including these entries is stored 
+ * in rank, if it's not NULL. Returns the entry after update[0]. */
+static olist_entry *
+olist_find(olist *l, void *value, bool after_equal, olist_entry **update, u_int32_t *rank) {
+   olist_entry *e = NULL, *next;
+   u_int32_t i = l->level, r = 0;
+   int c;
+
+   while (i-- > 0) {
+      while ((next = *olist_next(l, e, i))) {
+         c = l->cmp_func(value, next->value);
+
+         if (c < 0 || (c == 0 && !after_equal)) {
             break;
-         } 
-         cur = cur->next; 
+         }
+
+         r += i ? *olist_span(l, e, i) : 1;
+         e = next;
+      }
+
+      update[i] = e;
+      if (rank) {
+         rank[i] = r;
+      }
+   }
+
+   return *olist_next(l, e, 0);
+}
+
+/* Returns the entry at the given index, or NULL */
+static olist_entry *
+olist_find_index(olist *l, u_int32_t index) {
+   olist_entry *e = NULL, *next;
+   u_int32_t i = l->level, r = 0, span;
+
+   if (index >= l->size) {
+      return NULL;
+   }
+
+   /* Look for the entry of rank index+1 */
+   while (i-- > 0) {
+      while ((next = *olist_next(l, e, i)) && r + (span = i ? *olist_span(l, e, i) : 1) <= index + 1) {
+         r += span;
+         e = next;
+      }
+
+      if (r == index + 1) {
+         return e;
+      }
+   }
+
+   return NULL;
+}
+
+/* Fills update with the last entry before e on every level, by following
+ * the links back from e. This takes O(log n) steps without comparing any 
+ * values. */
+static void
+olist_preds(olist *l, olist_entry *e, olist_entry **update) {
+   olist_entry *x = e->prev;
+   u_int32_t i;
+
+   update[0] = x;
+
+   for (i=1; i < l->level; i++) {
+      while (x && x->height <= i) {
+         x = i > 1 ? x->skip[i-2].prev : x->prev;
       }
+      update[i] = x;
+   }
+}
 
-      if (!cur) {
-         e->prev = l->last; 
-         l->last->next = e;
-         l->last = e;
+/* Unlinks e. update holds the last entry before e on every level. */
+static void
+olist_unlink(olist *l, olist_entry *e, olist_entry **update) {
+   u_int32_t i;
+
+   for (i=1; i < l->level; i++) {
+      if (*olist_next(l, update[i], i) == e) {
+         *olist_span(l, update[i], i) += e->skip[i-1].span - 1;
+         *olist_next(l, update[i], i) = e->skip[i-1].next;
+
+         if (e->skip[i-1].next) {
+            e->skip[i-1].next->skip[i-1].prev = update[i];
+         }
+      } else {
+         *olist_span(l, update[i], i) -= 1;
       }
+   }
+
+   if (e->prev) {
+      e->prev->next = e->next;
+   } else {
+      l->first = e->next;
+   }
 
+   if (e->next) {
+      e->next->prev = e->prev;
+   } else {
+      l->last = e->prev;
+   }
+
+   while (l->level > 1 && l->skip[l->level-2].next == NULL) {
+      l->level--;
+   }
+
+   l->size--;
+}
+
+static olist_entry *
+olist_new_entry(olist *l, void *value) {
+   u_int32_t h = random_height(l);
+   olist_entry *e = (olist_entry *)calloc(1, sizeof(olist_entry) + (h-1) * sizeof(olist_link));
+
+   e->value = value;
+   e->height = h;
+
+   return e;
+}
+
+/* Links e in front of the first value which isn't smaller than its value */
+static void
+olist_link_entry(olist *l, olist_entry *e) {
+   olist_entry *update[OL_LEVELS];
+   u_int32_t rank[OL_LEVELS];
+   u_int32_t h = e->height, i;
+   olist_entry *next = olist_find(l, e->value, false, update, rank);
+
+   for (i=l->level; i < h; i++) {
+      update[i] = NULL;
+      rank[i] = 0;
+      l->skip[i-1].span = l->size;
+   }
+   if (h > l->level) {
+      l->level = h;
+   }
+
+   for (i=1; i < h; i++) {
+      e->skip[i-1].next = *olist_next(l, update[i], i);
+      e->skip[i-1].prev = update[i];
+      *olist_next(l, update[i], i) = e;
+
+      if (e->skip[i-1].next) {
+         e->skip[i-1].next->skip[i-1].prev = e;
+      }
+
+      e->skip[i-1].span = *olist_span(l, update[i], i) - (rank[0] - rank[i]);
+      *olist_span(l, update[i], i) = rank[0] - rank[i] + 1;
+   }
+
+   /* The links above the entry now span one more entry */
+   for (i=h; i < l->level; i++) {
+      *olist_span(l, update[i], i) += 1;
+   }
+
+   e->prev = update[0];
+   e->next = next;
+   *olist_next(l, update[0], 0) = e;
+
+   if (next) {
+      next->prev = e;
    } else {
       l->last = e;
-      l->first = e;
    }
 
    l->size++;
 }
 
+/* Inserts value before the first value which isn't smaller, so it's put in
+ * front of equal values. Returns the entry of the value, which stays valid
+ * until the value is removed. */
+olist_entry *
+olist_insert(olist *l, void *value) {
+   olist_entry *e = olist_new_entry(l, value);
+
+   olist_link_entry(l, e);
+
+   return e;
+}
+
+/* Sets prev and the links above level 0 of all entries, following the 
+ * next links of level 0 from l->first */
+static void
+olist_relink(olist *l) {
+   olist_entry *last[OL_LEVELS] = { NULL };
+   u_int32_t rank[OL_LEVELS] = { 0 };
+   olist_entry *e, *prev = NULL;
+   u_int32_t r = 0, i;
+
+   l->level = 1;
+
+   for (e=l->first; e; prev=e, e=e->next) {
+      e->prev = prev;
+      r++;
+
+      for (i=1; i < e->height; i++) {
+         *olist_next(l, last[i], i) = e;
+         *olist_span(l, last[i], i) = r - rank[i];
+         e->skip[i-1].prev = last[i];
+         last[i] = e;
+         rank[i] = r;
+      }
+
+      if (e->height > l->level) {
+         l->level = e->height;
+      }
+   }
+
+   for (i=1; i < OL_LEVELS; i++) {
+      *olist_next(l, last[i], i) = NULL;
+      *olist_span(l, last[i], i) = l->size - rank[i];
+   }
+
+   l->last = prev;
+}
+
+/* Merges two chains of entries linked by next. An entry of a goes before 
+ * equal entries of b. */
+static olist_entry *
+merge_chains(olist *l, olist_entry *a, olist_entry *b) {
+   olist_entry *first = NULL, **tail = &first;
+
+   while (a && b) {
+      if (l->cmp_func(a->value, b->value) <= 0) {
+         *tail = a;
+         a = a->next;
+      } else {
+         *tail = b;
+         b = b->next;
+      }
+      tail = &(*tail)->next;
+   }
+
+   *tail = a ? a : b;
+
+   return first;
+}
+
+/* Stable merge sort of n values, with insertion sort for short runs */
+static void
+sort_values(olist *l, void **v, u_int32_t n) {
+   void **tmp = (void **)calloc(n, sizeof(void *)), **src = v, **dst = tmp, **swp;
+   u_int32_t run = 16, i, j, k, lo, mid, hi;
+   void *x;
+
+   for (lo=0; lo < n; lo+=run) {
+      hi = lo + run < n ? lo + run : n;
+
+      for (i=lo + 1; i < hi; i++) {
+         x = v[i];
+         for (j=i; j > lo && l->cmp_func(x, v[j-1]) < 0; j--) {
+            v[j] = v[j-1];
+         }
+         v[j] = x;
+      }
+   }
+
+   for (; run < n; run *= 2) {
+      for (lo=0; lo < n; lo+=2 * run) {
+         mid = lo + run < n ? lo + run : n;
+         hi = lo + 2 * run < n ? lo + 2 * run : n;
+
+         for (i=lo, j=mid, k=lo; k < hi; k++) {
+            if (i < mid && (j >= hi || l->cmp_func(src[i], src[j]) <= 0)) {
+               dst[k] = src[i++];
+            } else {
+               dst[k] = src[j++];
+            }
+         }
+      }
+
+      swp = src;
+      src = dst;
+      dst = swp;
+   }
+
+   if (src != v) {
+      for (i=0; i < n; i++) {
+         v[i] = src[i];
+      }
+   }
+
+   free(tmp);
+}
+
+/* 
+ * Inserts n values, with the same result as inserting them one after 
+ * another. The values are sorted and merged into the list in one pass, 
+ * after which the links above level 0 are rebuilt. A few values into a 
+ * large list are inserted one by one instead.
+ */
+void
+olist_insert_many(olist *l, void **values, u_int32_t n) {
+   void **sorted;
+   olist_entry *chain = NULL;
+   u_int32_t i;
+
+   if ((u_int64_t)n * OL_LEVELS < l->size) {
+      for (i=0; i < n; i++) {
+         olist_insert(l, values[i]);
+      }
+      return;
+   }
+
+   /* A value goes before the equal values inserted earlier, so the sort 
+    * starts from the reversed batch */
+   sorted = (void **)calloc(n ? n : 1, sizeof(void *));
+   for (i=0; i < n; i++) {
+      sorted[i] = values[n - 1 - i];
+   }
+   sort_values(l, sorted, n);
+
+   for (i=n; i-- > 0; ) {
+      olist_entry *e = olist_new_entry(l, sorted[i]);
+      e->next = chain;
+      chain = e;
+   }
+   free(sorted);
+
+   l->first = merge_chains(l, chain, l->first);
+   l->size += n;
+   olist_relink(l);
+}
+
+/* 
+ * Moves all entries of src into l in linear time, src is left empty. 
+ * Values of src go before equal values of l and keep their order. Both 
+ * lists must use the same cmp_func. The entries stay valid as handles.
+ */
+void
+olist_merge(olist *l, olist *src) {
+   l->first = merge_chains(l, src->first, l->first);
+   l->size += src->size;
+   olist_relink(l);
+
+   src->first = NULL;
+   src->size = 0;
+   olist_relink(src);
+}
+
 void *
 olist_remove_first(olist *l) {
+   olist_entry *update[OL_LEVELS] = { NULL };
    olist_entry *e; 
    void *value;
 
@@ -107,14 +448,7 @@ olist_remove_first(olist *l) {
    }
 
    e = l->first; 
-
-   if (--l->size == 0)  {
-      l->last = NULL; 
-      l->first = NULL; 
-   } else if (e->next) {
-      e->next->prev = NULL;
-      l->first = e->next;
-   }
+   olist_unlink(l, e, update);
 
    value = e->value;
    free(e);
@@ -124,56 +458,61 @@ olist_remove_first(olist *l) {
 
 void *
 olist_remove_last(olist *l) {
-   olist_entry *e; 
-   void *value;
-
    if (olist_is_empty(l)) {
       return NULL; 
    }
 
-   e = l->last; 
+   return olist_remove_handle(l, l->last);
+}
 
-   if (--l->size == 0)  {
-      l->last = NULL; 
-      l->first = NULL; 
-   } else if (e->prev) {
-      e->prev->next = NULL;
-      l->last = e->prev;
+/* Removes the first value which is equal to value */
+void *
+olist_remove(olist *l, void *value) {
+   olist_entry *update[OL_LEVELS];
+   olist_entry *e = olist_find(l, value, false, update, NULL);
+   void *ret;
+
+   if (!e || l->cmp_func(value, e->value)) {
+      return NULL;
    }
 
-   value = e->value;
+   olist_unlink(l, e, update);
+
+   ret = e->value;
    free(e);
-   
-   return value;
+   return ret;
 }
 
+/* Removes the entry returned by olist_insert, without searching for it */
 void *
-olist_remove(olist *l, void *value) {
-   olist_entry *cur = l->first;
-
-   while (cur) {
-      if (!l->cmp_func(value, cur->value)) {
-         if (cur->prev) {
-            cur->prev->next = cur->next;
-         } else {
-            l->first = cur->next;
-         }
+olist_remove_handle(olist *l, olist_entry *e) {
+   olist_entry *update[OL_LEVELS];
+   void *value;
 
-         if (cur->next) {
-            cur->next->prev = cur->prev;
-         } else {
-            l->last = cur->prev;
-         }
+   olist_preds(l, e, update);
+   olist_unlink(l, e, update);
 
-         void *ret = cur->value;
-         free(cur);
-         l->size--;
-         return ret;
-      }
-      cur = cur->next;
+   value = e->value;
+   free(e);
+
+   return value;
+}
+
+/* Moves the entry to its place after the key of its value has changed. The
+ * entry stays valid. */
+void
+olist_update_key(olist *l, olist_entry *e) {
+   olist_entry *update[OL_LEVELS];
+
+   /* Nothing to do if the entry is still in place */
+   if ((!e->prev || l->cmp_func(e->value, e->prev->value) > 0) && 
+         (!e->next || l->cmp_func(e->value, e->next->value) <= 0)) {
+      return;
    }
 
-   return NULL;
+   olist_preds(l, e, update);
+   olist_unlink(l, e, update);
+   olist_link_entry(l, e);
 }
 
 void
@@ -188,6 +527,25 @@ olist_apply(olist *l, void(*f)(void *)) {
    olist_it_destroy(it);
 }
 
+/* Returns the number of values which are smaller than value */
+u_int32_t
+olist_rank(olist *l, void *value) {
+   olist_entry *update[OL_LEVELS];
+   u_int32_t rank[OL_LEVELS];
+
+   olist_find(l, value, false, update, rank);
+
+   return rank[0];
+}
+
+/* Returns the value at the given index, starting at 0, or NULL */
+void *
+olist_select(olist *l, u_int32_t index) {
+   olist_entry *e = olist_find_index(l, index);
+
+   return e ? e->value : NULL;
+}
+
 olist_it *
 olist_it_create(olist *l) {
    olist_it *it = (olist_it *)calloc(1, sizeof(olist_it));
@@ -203,17 +561,82 @@ olist_it_destroy(olist_it *it) {
    free(it);
 }
 
+olist_it *
+olist_it_create_reverse(olist *l) {
+   olist_it *it = olist_it_create(l);
+
+   it->reverse = true;
+   if (l) {
+      it->next = l->last;
+   }
+
+   return it;
+}
+
+/* Starts at the value with the given index */
+olist_it *
+olist_it_create_at(olist *l, u_int32_t index) {
+   olist_it *it = olist_it_create(l);
+
+   if (l) {
+      it->next = olist_find_index(l, index);
+   }
+
+   return it;
+}
+
+/* Starts at the first value which isn't smaller than value */
+olist_it *
+olist_it_lower_bound(olist *l, void *value) {
+   olist_entry *update[OL_LEVELS];
+   olist_it *it = olist_it_create(l);
+
+   if (l) {
+      it->next = olist_find(l, value, false, update, NULL);
+   }
+
+   return it;
+}
+
+/* Starts at the first value which is greater than value */
+olist_it *
+olist_it_upper_bound(olist *l, void *value) {
+   olist_entry *update[OL_LEVELS];
+   olist_it *it = olist_it_create(l);
+
+   if (l) {
+      it->next = olist_find(l, value, true, update, NULL);
+   }
+
+   return it;
+}
+
+/* Iterates the values from from up to and including to */
+olist_it *
+olist_it_range(olist *l, void *from, void *to) {
+   olist_entry *update[OL_LEVELS];
+   olist_it *it = olist_it_lower_bound(l, from);
+
+   if (l && l->cmp_func(from, to) > 0) {
+      it->next = NULL;
+   } else if (l) {
+      it->end = olist_find(l, to, true, update, NULL);
+   }
+
+   return it;
+}
+
 bool 
 olist_it_has_next(olist_it *it) {
-   return it->next != NULL;
+   return it->next != NULL && it->next != it->end;
 }
 
 void *
 olist_it_get_next(olist_it *it) {
    olist_entry *e = it->next;
 
-   if (e) {
-      it->next = e->next; 
+   if (olist_it_has_next(it)) {
+      it->next = it->reverse ? e->prev : e->next; 
       return e->value;
    } 
 
@@ -31,10 +31,33 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+/*
+ * The entries form a doubly linked list in ascending order, which is also 
+ * the bottom level of a skip list. An entry of height h is linked on the 
+ * levels 0 to h-1, the links above level 0 are kept in skip. Every level 
+ * holds about 1/OL_P of the entries of the level below, so inserting and 
+ * removing a value costs O(log n) comparisons. Every link also stores the 
+ * number of entries it spans, which gives the rank of an entry and the 
+ * entry at an index in O(log n).
+ */
+
+#define OL_LEVELS    32 /* Maximum height of an entry */
+#define OL_P         4  /* An entry reaches the next level with probability 1/OL_P */
+
+struct olist_entry;
+
+typedef struct {
+   struct olist_entry *next;         /* Next entry on the level */
+   struct olist_entry *prev;         /* Previous entry on the level, NULL for the list head */
+   u_int32_t span;                   /* Distance to next, or to the end of the list */
+} olist_link;
+
 typedef struct olist_entry {
    void *value;
    struct olist_entry *prev;
    struct olist_entry *next;
+   u_int32_t height;                 /* Number of levels the entry is linked on */
+   olist_link skip[];                /* Links on the levels 1 to height-1 */
 } olist_entry;
 
 typedef struct {
@@ -42,24 +65,40 @@ typedef struct {
    olist_entry *first;
    olist_entry *last;
    int (*cmp_func)(void *, void *);
+   u_int32_t level;                  /* Height of the highest entry */
+   u_int32_t rng;                    /* State of the generator for the heights */
+   olist_link skip[OL_LEVELS-1];     /* Links to the first entry on the levels 1 to OL_LEVELS-1 */
 } olist;
 
 typedef struct {
    olist *l;
    olist_entry *next;
+   olist_entry *end;                 /* Entry to stop at, NULL for the end of the list */
+   bool reverse;                     /* Iterate towards the first entry */
 } olist_it;
 
 olist *olist_create(int (*cmp_func)(void *, void *));
 void olist_destroy(olist *l);
 bool olist_is_empty(olist *l);
 u_int32_t olist_size(olist *l);
-void olist_insert(olist *l, void *value);
+olist_entry *olist_insert(olist *l, void *value);
+void olist_insert_many(olist *l, void **values, u_int32_t n);
+void olist_merge(olist *l, olist *src);
 void *olist_remove_first(olist *l);
 void *olist_remove_last(olist *l);
 void *olist_remove(olist *l, void *value);
+void *olist_remove_handle(olist *l, olist_entry *e);
+void olist_update_key(olist *l, olist_entry *e);
 void olist_apply(olist *l, void(*f)(void *));
+u_int32_t olist_rank(olist *l, void *value);
+void *olist_select(olist *l, u_int32_t index);
 
 olist_it *olist_it_create(olist *l);
+olist_it *olist_it_create_reverse(olist *l);
+olist_it *olist_it_create_at(olist *l, u_int32_t index);
+olist_it *olist_it_lower_bound(olist *l, void *value);
+olist_it *olist_it_upper_bound(olist *l, void *value);
+olist_it *olist_it_range(olist *l, void *from, void *to);
 void olist_it_destroy(olist_it *it);
 bool olist_it_has_next(olist_it *it);
 void *olist_it_get_next(olist_it *it);
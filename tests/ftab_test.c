@@ -0,0 +1,75 @@
+/*
+ * Freezes tables whose keys share their hashes in pairs. Built with a 
+ * small FT_PILOTS, most salts fail, so the build has to retry them and 
+ * must not lose the keys moved to the overflow array on an earlier try.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "../ftab.h"
+
+static long
+hash_pair(void *key) {
+   return (long)((uintptr_t)key / 2);
+}
+
+static bool
+equals_key(void *a, void *b) {
+   return a == b;
+}
+
+int
+main(void) {
+   uint32_t sizes[] = { 1, 2, 10, 100, 200 };
+   uint32_t s, i, failed = 0;
+
+   for (s=0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+      htab *ht = htab_create(hash_pair, equals_key);
+      ftab *f;
+      ftab_it *it;
+      uint32_t n = 0;
+
+      /* Key 0 is NULL, which has to be kept as well */
+      for (i=0; i < sizes[s]; i++) {
+         htab_put(ht, (void *)(uintptr_t)i, (void *)(uintptr_t)(i + 1));
+      }
+
+      f = ftab_freeze(ht);
+
+      for (i=0; i < sizes[s]; i++) {
+         if (ftab_get(f, (void *)(uintptr_t)i) != (void *)(uintptr_t)(i + 1)) {
+            printf("%u keys: key %u missing\n", sizes[s], i);
+            failed++;
+         }
+      }
+      for (i=sizes[s]; i < 2 * sizes[s]; i++) {
+         if (ftab_get(f, (void *)(uintptr_t)i) != NULL) {
+            printf("%u keys: key %u found\n", sizes[s], i);
+            failed++;
+         }
+      }
+
+      it = ftab_it_create(f);
+      while (ftab_it_has_next(it)) {
+         ftab_entry *e = ftab_it_get_next(it);
+         if (e->value != (void *)((uintptr_t)e->key + 1)) {
+            failed++;
+         }
+         n++;
+      }
+      ftab_it_destroy(it);
+
+      if (n != sizes[s] || ftab_size(f) != sizes[s]) {
+         printf("%u keys: iterated %u, size %u\n", sizes[s], n, ftab_size(f));
+         failed++;
+      }
+
+      ftab_destroy(f);
+      htab_destroy(ht);
+   }
+
+   printf("ftab_test: %s\n", failed ? "FAILED" : "ok");
+
+   return failed != 0;
+}
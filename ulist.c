@@ -0,0 +1,239 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "ulist.h"
+
+ulist *
+ulist_create() {
+   return (ulist *)calloc(1, sizeof(ulist));
+}
+
+void
+ulist_destroy(ulist *l) {
+   ulist_chunk *c = l->first, *tmp;
+
+   while (c) {
+      tmp = c->next;
+      free(c);
+      c = tmp;
+   }
+
+   free(l->spare);
+   free(l);
+}
+
+inline bool
+ulist_is_empty(ulist *l) {
+   return l->size == 0;
+}
+
+inline uint32_t
+ulist_size(ulist *l) {
+   return l->size;
+}
+
+/* Returns an empty chunk whose values start at start */
+static ulist_chunk *
+chunk_alloc(ulist *l, uint32_t start) {
+   ulist_chunk *c = l->spare;
+
+   if (c) {
+      l->spare = NULL;
+   } else {
+      c = (ulist_chunk *)aligned_alloc(64, sizeof(ulist_chunk));
+   }
+
+   c->prev = NULL;
+   c->next = NULL;
+   c->start = start;
+   c->count = 0;
+
+   return c;
+}
+
+/* Unlinks an empty chunk and keeps it as spare, or frees it */
+static void
+chunk_free(ulist *l, ulist_chunk *c) {
+   if (c->prev) {
+      c->prev->next = c->next;
+   } else {
+      l->first = c->next;
+   }
+
+   if (c->next) {
+      c->next->prev = c->prev;
+   } else {
+      l->last = c->prev;
+   }
+
+   if (l->spare) {
+      free(c);
+   } else {
+      l->spare = c;
+   }
+}
+
+void
+ulist_insert(ulist *l, void *value) {
+   ulist_chunk *c = l->first;
+
+   if (!c || c->start == 0) {
+      /* Fill a new chunk from its end, so further inserts fit */
+      c = chunk_alloc(l, UL_CHUNK);
+      c->next = l->first;
+
+      if (l->first) {
+         l->first->prev = c;
+      } else {
+         l->last = c;
+      }
+
+      l->first = c;
+   }
+
+   c->values[--c->start] = value;
+   c->count++;
+   l->size++;
+}
+
+void
+ulist_append(ulist *l, void *value) {
+   ulist_chunk *c = l->last;
+
+   if (!c || c->start + c->count == UL_CHUNK) {
+      c = chunk_alloc(l, 0);
+      c->prev = l->last;
+
+      if (l->last) {
+         l->last->next = c;
+      } else {
+         l->first = c;
+      }
+
+      l->last = c;
+   }
+
+   c->values[c->start + c->count++] = value;
+   l->size++;
+}
+
+void *
+ulist_remove_first(ulist *l) {
+   ulist_chunk *c = l->first;
+   void *value;
+
+   if (ulist_is_empty(l)) {
+      return NULL;
+   }
+
+   value = c->values[c->start++];
+   l->size--;
+
+   if (--c->count == 0) {
+      chunk_free(l, c);
+   }
+
+   return value;
+}
+
+void *
+ulist_remove_last(ulist *l) {
+   ulist_chunk *c = l->last;
+   void *value;
+
+   if (ulist_is_empty(l)) {
+      return NULL;
+   }
+
+   value = c->values[c->start + --c->count];
+   l->size--;
+
+   if (c->count == 0) {
+      chunk_free(l, c);
+   }
+
+   return value;
+}
+
+void
+ulist_apply(ulist *l, void (*f)(void *)) {
+   ulist_chunk *c;
+   uint32_t i;
+
+   for (c=l->first; c; c=c->next) {
+      for (i=c->start; i < c->start + c->count; i++) {
+         if (c->values[i]) {
+            f(c->values[i]);
+         }
+      }
+   }
+}
+
+ulist_it *
+ulist_it_create(ulist *l) {
+   ulist_it *it = (ulist_it *)calloc(1, sizeof(ulist_it));
+
+   if (l) {
+      it->l = l;
+      it->chunk = l->first;
+      it->pos = l->first ? l->first->start : 0;
+   }
+
+   return it;
+}
+
+void
+ulist_it_destroy(ulist_it *it) {
+   free(it);
+}
+
+bool 
+ulist_it_has_next(ulist_it *it) {
+   return it->chunk != NULL;
+}
+
+void *
+ulist_it_get_next(ulist_it *it) {
+   ulist_chunk *c = it->chunk;
+   void *value;
+
+   if (!c) {
+      return NULL;
+   }
+
+   value = c->values[it->pos++];
+
+   if (it->pos == c->start + c->count) {
+      it->chunk = c->next;
+      it->pos = c->next ? c->next->start : 0;
+   }
+
+   return value;
+}
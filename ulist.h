@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2026, Adrian Moser
+ *  All rights reserved.
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  * Redistributions of source code must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *  notice, this list of conditions and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *  * Neither the name of the author nor the
+ *  names of its contributors may be used to endorse or promote products
+ *  derived from this software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL AUTHOR BE LIABLE FOR ANY
+ *  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _ULIST_H_
+#define _ULIST_H_
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Unrolled list with the interface of list. The values are kept in chunks
+ * of UL_CHUNK pointers, which are linked like the entries of a list. A 
+ * chunk spans four cache lines, so a list needs about 9 bytes per value 
+ * and iterating it touches a new cache line only every 8 values. The 
+ * values of a chunk are at [start, start+count), so values are added and
+ * removed at both ends without moving others. One empty chunk is kept 
+ * for reuse, so a list used as a queue doesn't allocate in steady state.
+ * Unlike list, there are no entries which could serve as handles.
+ */
+
+#define UL_CHUNK     29 /* Values per chunk, makes a chunk 256 bytes */
+
+typedef struct ulist_chunk {
+   struct ulist_chunk *prev;
+   struct ulist_chunk *next;
+   uint32_t start;                   /* Index of the first value */
+   uint32_t count;                   /* Number of values */
+   void *values[UL_CHUNK];
+} ulist_chunk;
+
+typedef struct {
+   uint32_t size;
+   ulist_chunk *first;
+   ulist_chunk *last;
+   ulist_chunk *spare;               /* Empty chunk kept for reuse */
+} ulist;
+
+typedef struct {
+   ulist *l;
+   ulist_chunk *chunk;
+   uint32_t pos;                     /* Index of the next value in chunk */
+} ulist_it;
+
+ulist *ulist_create();
+void ulist_destroy(ulist *l);
+bool ulist_is_empty(ulist *l);
+uint32_t ulist_size(ulist *l);
+void ulist_insert(ulist *l, void *value);
+void ulist_append(ulist *l, void *value);
+void *ulist_remove_first(ulist *l);
+void *ulist_remove_last(ulist *l);
+void ulist_apply(ulist *l, void(*f)(void *));
+
+ulist_it *ulist_it_create(ulist *l);
+void ulist_it_destroy(ulist_it *it);
+bool ulist_it_has_next(ulist_it *it);
+void *ulist_it_get_next(ulist_it *it);
+
+#endif //_ULIST_H_